@@ -18,6 +18,9 @@ pushd win64
 
 if "%~1" NEQ "" (
   if /i "%~1"=="headerify"   goto headerify
+  if /i "%~1"=="bench"       goto bench
+  if /i "%~1"=="driver"      goto driver
+  if /i "%~1"=="test"        goto test
   goto eof
 )
 goto bigint
@@ -34,6 +37,24 @@ goto :eof
     echo.
 goto :eof
 
+:driver
+    echo Compiling Bigint Driver...
+	cl /nologo /MT /Gm- /GR- /EHsc /O2 /Oi /WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4706 /wd4996 /wd4127 /FC /Z7 /Fm ../../code/bigint_driver.cpp /link /incremental:no /opt:ref /subsystem:console,%SUBSYSTEM% /OUT:bigint_driver.exe
+    echo.
+goto :eof
+
+:test
+    echo Compiling Bigint Self-Checking Tests...
+	cl /nologo /MT /Gm- /GR- /EHsc /O2 /Oi /WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4706 /wd4996 /wd4127 /FC /Z7 /Fm ../../code/bigint_test.cpp /link /incremental:no /opt:ref /subsystem:console,%SUBSYSTEM% /OUT:bigint_test.exe
+    echo.
+goto :eof
+
+:bench
+    echo Compiling Bigint Benchmarks...
+	cl /nologo /MT /Gm- /GR- /EHsc /O2 /Oi /WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4706 /wd4996 /wd4127 /FC /Z7 /Fm ../../code/bigint_bench.cpp /link /incremental:no /opt:ref /subsystem:console,%SUBSYSTEM% /OUT:bigint_bench.exe
+    echo.
+goto :eof
+
 :eof
 popd
 popd
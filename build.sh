@@ -0,0 +1,43 @@
+#!/bin/sh
+# Linux/macOS counterpart of build.bat. Optimized builds go to build/linux.
+#   ./build.sh          prime search / factoring driver
+#   ./build.sh driver   prime search / factoring driver
+#   ./build.sh bench    benchmarks
+#   ./build.sh test     self-checking tests (run build/linux/bigint_test)
+# CXX picks the compiler (g++ by default; clang++ works the same). CXXFLAGS is
+# appended, e.g. CXXFLAGS=-DBIGINT_STATS for the operation counters, or
+# CXXFLAGS=-march=native to tune for this machine (the batch kernels pick their
+# instruction set at run time either way).
+set -e
+
+CXX=${CXX:-g++}
+CODE=$(cd "$(dirname "$0")/code" && pwd)
+mkdir -p "$(dirname "$0")/build/linux"
+cd "$(dirname "$0")/build/linux"
+
+FLAGS="-std=c++14 -O2 -pthread -Wall -Wno-unused-function $CXXFLAGS"
+
+driver()
+{
+    echo "Compiling Bigint Driver..."
+    $CXX $FLAGS "$CODE/bigint_driver.cpp" -o bigint
+}
+
+bench()
+{
+    echo "Compiling Bigint Benchmarks..."
+    $CXX $FLAGS "$CODE/bigint_bench.cpp" -o bigint_bench
+}
+
+tests()
+{
+    echo "Compiling Bigint Tests..."
+    $CXX $FLAGS "$CODE/bigint_test.cpp" -o bigint_test
+}
+
+case "${1:-driver}" in
+    driver) driver ;;
+    bench) bench ;;
+    test) tests ;;
+    *) echo "usage: $0 [driver|bench|test]" >&2; exit 1 ;;
+esac
@@ -1,292 +1,2226 @@
 #if !defined(BIGINT_CPP)
-#include <stdint.h>
-#include <assert.h>
+#include "bigint_platform.h"
 typedef unsigned int uint;
 
-#define UINT512_PARTS 16
-// Little endian. First part is the least significant, (Length-1) is the most.
-struct uint512 
+// Fixed-width unsigned integer of Bits bits, stored as 64-bit limbs so carries
+// can ride the hardware add-with-carry chain.
+// Little endian. First part is the least significant, (PartCount-1) is the most.
+template <uint32_t Bits>
+struct uintn
 {
-    uint32_t Parts[UINT512_PARTS];
+    static_assert(Bits % 64 == 0 && Bits > 0, "uintn width must be a whole number of 64-bit parts");
+    static const int32_t PartCount = Bits / 64;
+
+    uint64_t Parts[PartCount];
     
-    uint512();
-    uint512(int C);
-    uint512(uint C);
-    uint512(uint64_t C);
-    uint512(uint32_t Parts[UINT512_PARTS]);
+    constexpr uintn();
+    constexpr uintn(int C);
+    constexpr uintn(uint C);
+    // uint64_t is unsigned long on LP64 Linux and unsigned long long on Windows
+    // and macOS; taking both means 0x...ull and uint64_t values each match one
+    // constructor exactly on every platform.
+    constexpr uintn(unsigned long C);
+    constexpr uintn(unsigned long long C);
+    constexpr uintn(const uint64_t Parts[PartCount]);
+};
+
+typedef uintn<256> uint256;
+typedef uintn<512> uint512;
+typedef uintn<1024> uint1024;
+typedef uintn<2048> uint2048;
+typedef uintn<4096> uint4096;
+
+#define UINT512_PARTS (uint512::PartCount)
+
+// Right-hand operands are taken through this so they are not deduced; plain
+// integers then convert implicitly (N % 10, I + 6).
+template <uint32_t Bits>
+struct uintn_operand
+{
+    typedef uintn<Bits> type;
+};
+
+// OPERATION COUNTERS:
+// Build with BIGINT_STATS defined to count what the arithmetic actually does:
+// calls per operation, iterations of the multiply and divide loops, and the
+// bit lengths of the operands each operation saw. Without it every hook below
+// expands to nothing, so the default build is unchanged.
+//
+// Each thread counts into its own block, so the hot path takes no lock and
+// shares no cache line. BigintStatsSnapshot() sums every live thread's block
+// plus whatever threads that already exited left behind; BigintStatsReset()
+// zeroes them all. Both are meant for quiet points (between runs): counts taken
+// while other threads are mid-operation are only approximate.
+//
+// Derived operators count as the primitives they call: A + B is one add, A > B
+// is one less-than, A *= B is one multiply. uintn_tracked operations count
+// under the same entries. Constant evaluation is not counted.
+enum bigint_stat_op
+{
+    BigintOp_Add,                // +=, + (either operand kind)
+    BigintOp_Subtract,           // -=, -
+    BigintOp_Multiply,           // *, *=
+    BigintOp_MultiplyWide,       // UIntMultiplyWide
+    BigintOp_Square,             // UIntSquare
+    BigintOp_AddMul,             // UIntAddMul, UIntMultiplyAddPart
+    BigintOp_Divide,             // /, /=
+    BigintOp_Modulo,             // %, %=
+    BigintOp_Division,           // UIntDivision (behind / and % as well)
+    BigintOp_DivideByPart,       // UIntDivideByPart
+    BigintOp_RemainderByPart,    // UIntRemainderByPart
+    BigintOp_Less,               // <, and >, <=, >= through it
+    BigintOp_Equal,              // ==, !=
+    BigintOp_ShiftLeft,          // <<=, <<
+    BigintOp_ShiftRight,         // >>=, >>
+    BigintOp_MontgomeryMultiply, // MontgomeryMultiply
+    BigintOp_MontgomerySquare,   // MontgomerySquare
+    BigintOp_Count
 };
 
-inline uint512 UINT512_MAX()
+enum bigint_stat_loop
+{
+    BigintLoop_LimbProducts,      // 64x64 products in the multiply, square and REDC kernels
+    BigintLoop_QuotientDigits,    // Algorithm D outer iterations (one per quotient limb)
+    BigintLoop_QuotientCorrections, // Quotient digit estimates stepped down before the multiply-subtract
+    BigintLoop_AddBacks,          // Multiply-subtracts that overshot and added the divisor back
+    BigintLoop_PartDivides,       // Hardware 128/64 divides in the single-part division loop
+    BigintLoop_Count
+};
+
+// Histogram bucket I holds operands of ((I - 1) * BUCKET_BITS, I * BUCKET_BITS]
+// significant bits; bucket 0 is the value zero and the last bucket takes
+// everything from BIGINT_STATS_MAX_BITS up.
+#if !defined(BIGINT_STATS_BUCKET_BITS)
+#define BIGINT_STATS_BUCKET_BITS 64
+#endif
+#if !defined(BIGINT_STATS_MAX_BITS)
+#define BIGINT_STATS_MAX_BITS 4096
+#endif
+#define BIGINT_STATS_BUCKETS (BIGINT_STATS_MAX_BITS / BIGINT_STATS_BUCKET_BITS + 1)
+
+struct bigint_stats
+{
+    uint64_t Calls[BigintOp_Count];
+    uint64_t Iterations[BigintLoop_Count];
+    uint64_t LeftBits[BigintOp_Count][BIGINT_STATS_BUCKETS];  // Left (or only) operand
+    uint64_t RightBits[BigintOp_Count][BIGINT_STATS_BUCKETS]; // Right operand, for the binary operations
+};
+
+#if defined(BIGINT_STATS)
+#include <atomic>
+#include <mutex>
+
+// The owning thread is the only writer, so a relaxed load and store is enough
+// to bump a counter; the atomics only make the cross-thread reads well defined.
+struct bigint_stats_thread
+{
+    std::atomic<uint64_t> Calls[BigintOp_Count];
+    std::atomic<uint64_t> Iterations[BigintLoop_Count];
+    std::atomic<uint64_t> LeftBits[BigintOp_Count][BIGINT_STATS_BUCKETS];
+    std::atomic<uint64_t> RightBits[BigintOp_Count][BIGINT_STATS_BUCKETS];
+    bigint_stats_thread* Next;
+
+    bigint_stats_thread();
+    ~bigint_stats_thread();
+};
+
+struct bigint_stats_registry
+{
+    std::mutex Lock;
+    bigint_stats_thread* First;
+    bigint_stats Retired; // Totals of threads that have exited
+};
+
+static bigint_stats_registry*
+BigintStatsRegistry()
+{
+    static bigint_stats_registry Registry = {};
+    return &Registry;
+}
+
+inline void
+BigintStatsBump(std::atomic<uint64_t>* Counter, uint64_t Amount)
+{
+    Counter->store(Counter->load(std::memory_order_relaxed) + Amount, std::memory_order_relaxed);
+}
+
+// Destination[I] += Source[I] for one counter array, optionally zeroing Source.
+inline void
+BigintStatsCollectArray(uint64_t* Destination, std::atomic<uint64_t>* Source, size_t Count, bool Reset)
+{
+    for (size_t Index = 0; Index < Count; ++Index)
+    {
+        Destination[Index] += Source[Index].load(std::memory_order_relaxed);
+        if (Reset) { Source[Index].store(0, std::memory_order_relaxed); }
+    }
+}
+
+// Adds the block's counts into Totals, optionally zeroing the block as it goes.
+inline void
+BigintStatsCollect(bigint_stats* Totals, bigint_stats_thread* Block, bool Reset)
+{
+    BigintStatsCollectArray(Totals->Calls, Block->Calls, BigintOp_Count, Reset);
+    BigintStatsCollectArray(Totals->Iterations, Block->Iterations, BigintLoop_Count, Reset);
+    for (int32_t Op = 0; Op < BigintOp_Count; ++Op)
+    {
+        BigintStatsCollectArray(Totals->LeftBits[Op], Block->LeftBits[Op], BIGINT_STATS_BUCKETS, Reset);
+        BigintStatsCollectArray(Totals->RightBits[Op], Block->RightBits[Op], BIGINT_STATS_BUCKETS, Reset);
+    }
+}
+
+inline void
+BigintStatsClearArray(std::atomic<uint64_t>* Counters, size_t Count)
+{
+    for (size_t Index = 0; Index < Count; ++Index) { Counters[Index].store(0, std::memory_order_relaxed); }
+}
+
+inline
+bigint_stats_thread::bigint_stats_thread()
+{
+    BigintStatsClearArray(Calls, BigintOp_Count);
+    BigintStatsClearArray(Iterations, BigintLoop_Count);
+    for (int32_t Op = 0; Op < BigintOp_Count; ++Op)
+    {
+        BigintStatsClearArray(LeftBits[Op], BIGINT_STATS_BUCKETS);
+        BigintStatsClearArray(RightBits[Op], BIGINT_STATS_BUCKETS);
+    }
+    bigint_stats_registry* Registry = BigintStatsRegistry();
+    std::lock_guard<std::mutex> Guard(Registry->Lock);
+    Next = Registry->First;
+    Registry->First = this;
+}
+
+inline
+bigint_stats_thread::~bigint_stats_thread()
+{
+    bigint_stats_registry* Registry = BigintStatsRegistry();
+    std::lock_guard<std::mutex> Guard(Registry->Lock);
+    BigintStatsCollect(&Registry->Retired, this, false);
+    bigint_stats_thread** Link = &Registry->First;
+    while (*Link != this) { Link = &(*Link)->Next; }
+    *Link = Next;
+}
+
+inline bigint_stats_thread*
+BigintStatsLocal()
+{
+    static thread_local bigint_stats_thread Block;
+    return &Block;
+}
+
+inline uint32_t
+BigintStatsBucket(uint32_t BitCount)
+{
+    uint32_t Bucket = (BitCount + BIGINT_STATS_BUCKET_BITS - 1) / BIGINT_STATS_BUCKET_BITS;
+    return (Bucket < BIGINT_STATS_BUCKETS) ? Bucket : BIGINT_STATS_BUCKETS - 1;
+}
+
+inline uint32_t
+BigintStatsBitCount(uint64_t A)
+{
+    uint32_t BitCount = 0;
+    while (A) { ++BitCount; A >>= 1; }
+    return BitCount;
+}
+
+template <uint32_t Bits>
+inline uint32_t
+BigintStatsBitCount(const uintn<Bits>& A)
+{
+    for (int32_t PartIndex = uintn<Bits>::PartCount - 1; PartIndex >= 0; --PartIndex)
+    {
+        if (A.Parts[PartIndex]) { return 64 * PartIndex + BigintStatsBitCount(A.Parts[PartIndex]); }
+    }
+    return 0;
+}
+
+#define BIGINT_STATS_NO_OPERAND 0xFFFFFFFF
+
+inline void
+BigintStatsRecord(bigint_stat_op Op, uint32_t LeftBitCount, uint32_t RightBitCount)
+{
+    bigint_stats_thread* Block = BigintStatsLocal();
+    BigintStatsBump(&Block->Calls[Op], 1);
+    BigintStatsBump(&Block->LeftBits[Op][BigintStatsBucket(LeftBitCount)], 1);
+    if (RightBitCount != BIGINT_STATS_NO_OPERAND)
+    {
+        BigintStatsBump(&Block->RightBits[Op][BigintStatsBucket(RightBitCount)], 1);
+    }
+}
+
+inline void
+BigintStatsIterate(bigint_stat_loop Loop, uint64_t Amount)
+{
+    BigintStatsBump(&BigintStatsLocal()->Iterations[Loop], Amount);
+}
+
+// Counts summed over every thread that has run bigint code so far.
+inline bigint_stats
+BigintStatsSnapshot()
+{
+    bigint_stats Totals = {};
+    bigint_stats_registry* Registry = BigintStatsRegistry();
+    std::lock_guard<std::mutex> Guard(Registry->Lock);
+    Totals = Registry->Retired;
+    for (bigint_stats_thread* Block = Registry->First; Block; Block = Block->Next)
+    {
+        BigintStatsCollect(&Totals, Block, false);
+    }
+    return Totals;
+}
+
+inline void
+BigintStatsReset()
+{
+    bigint_stats Discard = {};
+    bigint_stats_registry* Registry = BigintStatsRegistry();
+    std::lock_guard<std::mutex> Guard(Registry->Lock);
+    Registry->Retired = bigint_stats();
+    for (bigint_stats_thread* Block = Registry->First; Block; Block = Block->Next)
+    {
+        BigintStatsCollect(&Discard, Block, true);
+    }
+}
+
+#define BIGINT_COUNT_OP(Op, Left, Right) \
+    do { if (!UINTN_CONSTANT_EVALUATED()) { BigintStatsRecord(Op, BigintStatsBitCount(Left), BigintStatsBitCount(Right)); } } while (0)
+#define BIGINT_COUNT_UNARY(Op, Operand) \
+    do { if (!UINTN_CONSTANT_EVALUATED()) { BigintStatsRecord(Op, BigintStatsBitCount(Operand), BIGINT_STATS_NO_OPERAND); } } while (0)
+#define BIGINT_COUNT_LOOP(Loop, Amount) \
+    do { if (!UINTN_CONSTANT_EVALUATED()) { BigintStatsIterate(Loop, Amount); } } while (0)
+#else
+// Stubs so callers can use the API unconditionally; the snapshot is all zeros.
+inline bigint_stats BigintStatsSnapshot() { return bigint_stats(); }
+inline void BigintStatsReset() {}
+
+#define BIGINT_COUNT_OP(Op, Left, Right) ((void)0)
+#define BIGINT_COUNT_UNARY(Op, Operand) ((void)0)
+#define BIGINT_COUNT_LOOP(Loop, Amount) ((void)0)
+#endif
+
+template <uint32_t Bits>
+constexpr uintn<Bits> UIntMax()
 { 
-    uint512 Result;
-    for(int32_t PartIndex = 0; PartIndex < UINT512_PARTS; ++PartIndex)
+    uintn<Bits> Result;
+    UINTN_UNROLL
+    for(int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
     { 
-        Result.Parts[PartIndex] = 0xFFFFFFFF;
+        Result.Parts[PartIndex] = 0xFFFFFFFFFFFFFFFF;
+    }
+    return Result;
+}
+
+constexpr uint512 UINT512_MAX() { return UIntMax<512>(); }
+
+// Constant evaluation (before C++20) needs every part initialized, so even the
+// default constructor zeroes; where the parts are then overwritten the stores
+// are dead and the optimizer drops them.
+template <uint32_t Bits>
+constexpr uintn<Bits>::uintn()
+    : Parts()
+{
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>::uintn(int C)
+    : Parts()
+{
+    this->Parts[0] = (uint64_t)C;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>::uintn(uint C)
+    : Parts()
+{
+    this->Parts[0] = C;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>::uintn(unsigned long C)
+    : Parts()
+{
+    this->Parts[0] = C;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>::uintn(unsigned long long C)
+    : Parts()
+{
+    this->Parts[0] = C;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>::uintn(const uint64_t Parts[PartCount])
+    : Parts()
+{
+    UINTN_UNROLL
+    for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex) { this->Parts[PartIndex] = Parts[PartIndex]; }
+}
+
+template <uint32_t Bits>
+constexpr bool
+BigPartEqualsZero(const uintn<Bits>& A)
+{
+    uint64_t BigParts = 0;
+    UINTN_UNROLL
+    for (int32_t PartIndex = 1; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { BigParts |= A.Parts[PartIndex]; }
+    return BigParts == 0;
+}
+
+// Adds A * B into the three-limb column accumulator (C0 lowest).
+// GCC and clang schedule the 128-bit form much better than a chain of
+// AddWithCarry calls here, so they get it directly.
+constexpr void
+MultiplyAccumulate(uint64_t A, uint64_t B, uint64_t* C0, uint64_t* C1, uint64_t* C2)
+{
+#if UINTN_HAS_INT128
+    unsigned __int128 Product = (unsigned __int128)A * B;
+    unsigned __int128 Sum = (((unsigned __int128)*C1 << 64) | *C0) + Product;
+    *C2 += Sum < Product;
+    *C0 = (uint64_t)Sum;
+    *C1 = (uint64_t)(Sum >> 64);
+#else
+    uint64_t High = 0;
+    uint64_t Low = MultiplyWithHigh(A, B, &High);
+    uint8_t Carry = AddWithCarry(0, *C0, Low, C0);
+    Carry = AddWithCarry(Carry, *C1, High, C1);
+    *C2 += Carry;
+#endif
+}
+
+// Returns the low limb of A * B + Addend + *Carry and leaves the high limb in *Carry.
+// The sum cannot overflow 128 bits.
+constexpr uint64_t
+MultiplyAddWithCarry(uint64_t A, uint64_t B, uint64_t Addend, uint64_t* Carry)
+{
+#if UINTN_HAS_INT128
+    unsigned __int128 Sum = (unsigned __int128)A * B + Addend + *Carry;
+    *Carry = (uint64_t)(Sum >> 64);
+    return (uint64_t)Sum;
+#else
+    uint64_t High = 0;
+    uint64_t Low = MultiplyWithHigh(A, B, &High);
+    High += AddWithCarry(0, Low, Addend, &Low);
+    High += AddWithCarry(0, Low, *Carry, &Low);
+    *Carry = High;
+    return Low;
+#endif
+}
+
+// Adds 2 * A * B into the accumulator; used by squaring for the symmetric A[i]*A[j] pairs.
+constexpr void
+MultiplyAccumulateTwice(uint64_t A, uint64_t B, uint64_t* C0, uint64_t* C1, uint64_t* C2)
+{
+#if UINTN_HAS_INT128
+    unsigned __int128 Product = (unsigned __int128)A * B;
+    *C2 += (uint64_t)(Product >> 127);
+    Product <<= 1;
+    unsigned __int128 Sum = (((unsigned __int128)*C1 << 64) | *C0) + Product;
+    *C2 += Sum < Product;
+    *C0 = (uint64_t)Sum;
+    *C1 = (uint64_t)(Sum >> 64);
+#else
+    uint64_t High = 0;
+    uint64_t Low = MultiplyWithHigh(A, B, &High);
+    *C2 += High >> 63;
+    High = (High << 1) | (Low >> 63);
+    Low <<= 1;
+    uint8_t Carry = AddWithCarry(0, *C0, Low, C0);
+    Carry = AddWithCarry(Carry, *C1, High, C1);
+    *C2 += Carry;
+#endif
+}
+
+// Comba multiplication: the product is produced one column at a time by summing
+// every A[I] * B[J] with I + J == Column, so each result limb is stored exactly once.
+// Only the low ResultCount limbs are computed (Count for a truncated product,
+// 2 * Count for the full one). Result must not alias A or B.
+template <int32_t Count, int32_t ResultCount>
+constexpr void
+MultiplyLimbs(uint64_t* Result, const uint64_t* A, const uint64_t* B)
+{
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, (ResultCount >= 2 * Count) ? Count * Count : Count * (Count + 1) / 2);
+    uint64_t C0 = 0, C1 = 0, C2 = 0;
+    UINTN_UNROLL
+    for (int32_t Column = 0; Column < ResultCount; ++Column)
+    {
+        int32_t First = (Column < Count) ? 0 : Column - Count + 1;
+        int32_t Last = (Column < Count) ? Column : Count - 1;
+        for (int32_t Index = First; Index <= Last; ++Index)
+        {
+            MultiplyAccumulate(A[Index], B[Column - Index], &C0, &C1, &C2);
+        }
+        Result[Column] = C0;
+        C0 = C1;
+        C1 = C2;
+        C2 = 0;
+    }
+}
+
+// Comba squaring: A[I] * A[J] and A[J] * A[I] are the same product, so each
+// off-diagonal pair is multiplied once and added twice.
+template <int32_t Count, int32_t ResultCount>
+constexpr void
+SquareLimbs(uint64_t* Result, const uint64_t* A)
+{
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, Count * (Count + 1) / 2);
+    uint64_t C0 = 0, C1 = 0, C2 = 0;
+    UINTN_UNROLL
+    for (int32_t Column = 0; Column < ResultCount; ++Column)
+    {
+        int32_t First = (Column < Count) ? 0 : Column - Count + 1;
+        for (int32_t Index = First; Index < Column - Index; ++Index)
+        {
+            MultiplyAccumulateTwice(A[Index], A[Column - Index], &C0, &C1, &C2);
+        }
+        if ((Column & 1) == 0 && Column / 2 < Count)
+        {
+            MultiplyAccumulate(A[Column / 2], A[Column / 2], &C0, &C1, &C2);
+        }
+        Result[Column] = C0;
+        C0 = C1;
+        C1 = C2;
+        C2 = 0;
+    }
+}
+
+// Limb-array add/subtract used by the recursive kernels below. Result may alias
+// either operand. Each returns the carry/borrow out of the top limb.
+template <int32_t Count>
+constexpr uint8_t
+AddLimbs(uint64_t* Result, const uint64_t* A, const uint64_t* B)
+{
+    uint8_t Carry = 0;
+    UINTN_UNROLL
+    for (int32_t Index = 0; Index < Count; ++Index)
+    {
+        Carry = AddWithCarry(Carry, A[Index], B[Index], &Result[Index]);
+    }
+    return Carry;
+}
+
+template <int32_t Count>
+constexpr uint8_t
+SubtractLimbs(uint64_t* Result, const uint64_t* A, const uint64_t* B)
+{
+    uint8_t Borrow = 0;
+    UINTN_UNROLL
+    for (int32_t Index = 0; Index < Count; ++Index)
+    {
+        Borrow = SubtractWithBorrow(Borrow, A[Index], B[Index], &Result[Index]);
+    }
+    return Borrow;
+}
+
+// Adds a single limb into a Count-limb number, stopping as soon as the carry dies.
+constexpr void
+AddPartToLimbs(uint64_t* Result, int32_t Count, uint64_t Value)
+{
+    uint8_t Carry = AddWithCarry(0, Result[0], Value, &Result[0]);
+    for (int32_t Index = 1; Carry && Index < Count; ++Index)
+    {
+        Carry = AddWithCarry(Carry, Result[Index], 0, &Result[Index]);
+    }
+}
+
+// Result = |A - B|. Returns true if B was the larger one.
+template <int32_t Count>
+constexpr bool
+AbsoluteDifferenceLimbs(uint64_t* Result, const uint64_t* A, const uint64_t* B)
+{
+    int32_t Index = Count - 1;
+    while (Index > 0 && A[Index] == B[Index]) { --Index; }
+    if (A[Index] < B[Index])
+    {
+        SubtractLimbs<Count>(Result, B, A);
+        return true;
+    }
+    SubtractLimbs<Count>(Result, A, B);
+    return false;
+}
+
+// Limb count at and above which products split with Karatsuba instead of
+// running the Comba kernels directly. Only even counts split. Measured with
+// bigint_bench on x86-64; override at build time to retune.
+#if !defined(BIGINT_KARATSUBA_THRESHOLD)
+#define BIGINT_KARATSUBA_THRESHOLD 16
+#endif
+
+// Picks the multiplication kernel for a limb count at compile time:
+// Wide is the full 2 * Count product, Low the truncated Count-limb one.
+template <int32_t Count, bool Split = (Count >= BIGINT_KARATSUBA_THRESHOLD && (Count % 2) == 0)>
+struct limb_multiply
+{
+    static constexpr void Wide(uint64_t* Result, const uint64_t* A, const uint64_t* B) { MultiplyLimbs<Count, 2 * Count>(Result, A, B); }
+    static constexpr void Square(uint64_t* Result, const uint64_t* A) { SquareLimbs<Count, 2 * Count>(Result, A); }
+    static constexpr void Low(uint64_t* Result, const uint64_t* A, const uint64_t* B) { MultiplyLimbs<Count, Count>(Result, A, B); }
+};
+
+// Karatsuba: with A = A1 * b^H + A0 and B = B1 * b^H + B0,
+//   A * B = Z2 * b^2H + (Z0 + Z2 - (A0 - A1)(B0 - B1)) * b^H + Z0
+// where Z0 = A0 * B0 and Z2 = A1 * B1, so three half-size products replace four.
+// The differences are taken as magnitudes plus a sign so every operand stays H
+// limbs wide. All scratch lives in fixed-size arrays on the stack.
+// Result (2 * Count limbs) must not alias A or B.
+template <int32_t Count>
+constexpr void
+KaratsubaMultiplyLimbs(uint64_t* Result, const uint64_t* A, const uint64_t* B)
+{
+    static_assert(Count % 2 == 0, "Karatsuba splits an even number of limbs");
+    const int32_t Half = Count / 2;
+
+    limb_multiply<Half>::Wide(Result, A, B);
+    limb_multiply<Half>::Wide(Result + Count, A + Half, B + Half);
+
+    uint64_t DifferenceA[Half] = {};
+    uint64_t DifferenceB[Half] = {};
+    uint64_t Middle[Count] = {};
+    bool NegativeA = AbsoluteDifferenceLimbs<Half>(DifferenceA, A, A + Half);
+    bool NegativeB = AbsoluteDifferenceLimbs<Half>(DifferenceB, B, B + Half);
+    limb_multiply<Half>::Wide(Middle, DifferenceA, DifferenceB);
+
+    uint64_t Cross[Count] = {};
+    uint64_t CrossTop = AddLimbs<Count>(Cross, Result, Result + Count);
+    if (NegativeA == NegativeB) { CrossTop -= SubtractLimbs<Count>(Cross, Cross, Middle); }
+    else                        { CrossTop += AddLimbs<Count>(Cross, Cross, Middle); }
+
+    CrossTop += AddLimbs<Count>(Result + Half, Result + Half, Cross);
+    AddPartToLimbs(Result + Half + Count, Half, CrossTop);
+}
+
+// Karatsuba squaring: the middle term is Z0 + Z2 - (A0 - A1)^2, always a subtraction.
+template <int32_t Count>
+constexpr void
+KaratsubaSquareLimbs(uint64_t* Result, const uint64_t* A)
+{
+    static_assert(Count % 2 == 0, "Karatsuba splits an even number of limbs");
+    const int32_t Half = Count / 2;
+
+    limb_multiply<Half>::Square(Result, A);
+    limb_multiply<Half>::Square(Result + Count, A + Half);
+
+    uint64_t Difference[Half] = {};
+    uint64_t Middle[Count] = {};
+    AbsoluteDifferenceLimbs<Half>(Difference, A, A + Half);
+    limb_multiply<Half>::Square(Middle, Difference);
+
+    uint64_t Cross[Count] = {};
+    uint64_t CrossTop = AddLimbs<Count>(Cross, Result, Result + Count);
+    CrossTop -= SubtractLimbs<Count>(Cross, Cross, Middle);
+
+    CrossTop += AddLimbs<Count>(Result + Half, Result + Half, Cross);
+    AddPartToLimbs(Result + Half + Count, Half, CrossTop);
+}
+
+// Truncated product: only A0 * B0 needs to be full width; the cross terms
+// contribute their low halves and A1 * B1 falls off the top entirely.
+template <int32_t Count>
+constexpr void
+KaratsubaMultiplyLowLimbs(uint64_t* Result, const uint64_t* A, const uint64_t* B)
+{
+    static_assert(Count % 2 == 0, "Karatsuba splits an even number of limbs");
+    const int32_t Half = Count / 2;
+
+    limb_multiply<Half>::Wide(Result, A, B);
+
+    uint64_t Cross[Half] = {};
+    limb_multiply<Half>::Low(Cross, A, B + Half);
+    AddLimbs<Half>(Result + Half, Result + Half, Cross);
+    limb_multiply<Half>::Low(Cross, A + Half, B);
+    AddLimbs<Half>(Result + Half, Result + Half, Cross);
+}
+
+template <int32_t Count>
+struct limb_multiply<Count, true>
+{
+    static constexpr void Wide(uint64_t* Result, const uint64_t* A, const uint64_t* B) { KaratsubaMultiplyLimbs<Count>(Result, A, B); }
+    static constexpr void Square(uint64_t* Result, const uint64_t* A) { KaratsubaSquareLimbs<Count>(Result, A); }
+    static constexpr void Low(uint64_t* Result, const uint64_t* A, const uint64_t* B) { KaratsubaMultiplyLowLimbs<Count>(Result, A, B); }
+};
+
+// A single-part divisor prepared for dividing many numbers by the same value
+// without a hardware divide (Moller & Granlund, "Improved division by invariant
+// integers"): each 128/64 step becomes two multiplications and a couple of fixups.
+struct part_divisor
+{
+    uint64_t Normalized;  // Divisor << Shift, so the top bit is set
+    uint64_t Reciprocal;  // floor((2^128 - 1) / Normalized) - 2^64
+    uint32_t Shift;
+};
+
+constexpr part_divisor
+MakePartDivisor(uint64_t Divisor)
+{
+    assert(Divisor != 0);
+    part_divisor Result = {};
+    Result.Shift = CountLeadingZeros64(Divisor);
+    Result.Normalized = Divisor << Result.Shift;
+    uint64_t Unused = 0;
+    Result.Reciprocal = DivideWide(~Result.Normalized, 0xFFFFFFFFFFFFFFFF, Result.Normalized, &Unused);
+    return Result;
+}
+
+// Remainder of High:Low by Divisor->Normalized, with High < Normalized.
+constexpr uint64_t
+RemainderWidePreinverted(uint64_t High, uint64_t Low, const part_divisor* Divisor)
+{
+    uint64_t QuotientHigh = 0;
+    uint64_t QuotientLow = MultiplyWithHigh(Divisor->Reciprocal, High, &QuotientHigh);
+    QuotientHigh += High + AddWithCarry(0, QuotientLow, Low, &QuotientLow) + 1;
+    uint64_t Remainder = Low - QuotientHigh * Divisor->Normalized;
+    if (Remainder > QuotientLow) { Remainder += Divisor->Normalized; }
+    if (Remainder >= Divisor->Normalized) { Remainder -= Divisor->Normalized; }
+    return Remainder;
+}
+
+// Quotient of High:Low by Divisor->Normalized, with High < Normalized, and the
+// remainder in *Remainder. Same steps as RemainderWidePreinverted, keeping the
+// quotient estimate and applying the same fixups to it.
+constexpr uint64_t
+DivideWidePreinverted(uint64_t High, uint64_t Low, const part_divisor* Divisor, uint64_t* Remainder)
+{
+    uint64_t QuotientHigh = 0;
+    uint64_t QuotientLow = MultiplyWithHigh(Divisor->Reciprocal, High, &QuotientHigh);
+    QuotientHigh += High + AddWithCarry(0, QuotientLow, Low, &QuotientLow) + 1;
+    uint64_t Rest = Low - QuotientHigh * Divisor->Normalized;
+    if (Rest > QuotientLow)
+    {
+        --QuotientHigh;
+        Rest += Divisor->Normalized;
+    }
+    if (Rest >= Divisor->Normalized)
+    {
+        ++QuotientHigh;
+        Rest -= Divisor->Normalized;
+    }
+    *Remainder = Rest;
+    return QuotientHigh;
+}
+
+// Divides the Count-limb number A by a single limb, one hardware divide per limb.
+// Returns the remainder. Quotient may alias A.
+constexpr uint64_t
+DivideLimbsBySingle(uint64_t* Quotient, const uint64_t* A, int32_t Count, uint64_t Divisor)
+{
+    BIGINT_COUNT_LOOP(BigintLoop_PartDivides, Count);
+    uint64_t Remainder = 0;
+    for (int32_t PartIndex = Count - 1; PartIndex >= 0; --PartIndex)
+    {
+        Quotient[PartIndex] = DivideWide(Remainder, A[PartIndex], Divisor, &Remainder);
+    }
+    return Remainder;
+}
+
+// Knuth's Algorithm D (TAOCP Vol. 2, 4.3.1). U has UCount limbs and V has VCount
+// limbs with V[VCount - 1] != 0, VCount >= 2 and UCount >= VCount. Quotient receives
+// UCount - VCount + 1 limbs and Remainder receives VCount limbs. Scratch must hold
+// UCount + 1 + VCount limbs.
+constexpr void
+DivideLimbs(uint64_t* Quotient, uint64_t* Remainder,
+            const uint64_t* U, int32_t UCount, const uint64_t* V, int32_t VCount,
+            uint64_t* Scratch)
+{
+    uint64_t* UN = Scratch;
+    uint64_t* VN = Scratch + UCount + 1;
+
+    // Normalize so the top bit of the divisor is set; this keeps each quotient
+    // digit estimate within two of the true digit.
+    uint32_t Shift = CountLeadingZeros64(V[VCount - 1]);
+    if (Shift == 0)
+    {
+        for (int32_t I = 0; I < VCount; ++I) { VN[I] = V[I]; }
+        for (int32_t I = 0; I < UCount; ++I) { UN[I] = U[I]; }
+        UN[UCount] = 0;
+    }
+    else
+    {
+        for (int32_t I = VCount - 1; I > 0; --I) { VN[I] = (V[I] << Shift) | (V[I - 1] >> (64 - Shift)); }
+        VN[0] = V[0] << Shift;
+        UN[UCount] = U[UCount - 1] >> (64 - Shift);
+        for (int32_t I = UCount - 1; I > 0; --I) { UN[I] = (U[I] << Shift) | (U[I - 1] >> (64 - Shift)); }
+        UN[0] = U[0] << Shift;
+    }
+
+    uint64_t DivisorTop = VN[VCount - 1];
+    uint64_t DivisorNext = VN[VCount - 2];
+    BIGINT_COUNT_LOOP(BigintLoop_QuotientDigits, UCount - VCount + 1);
+    for (int32_t J = UCount - VCount; J >= 0; --J)
+    {
+        // Estimate the quotient digit from the top two dividend limbs.
+        uint64_t QHat = 0, RHat = 0;
+        bool RHatOverflowed = false;
+        if (UN[J + VCount] >= DivisorTop)
+        {
+            QHat = 0xFFFFFFFFFFFFFFFF;
+            RHat = UN[J + VCount - 1] + DivisorTop;
+            RHatOverflowed = RHat < DivisorTop;
+        }
+        else
+        {
+            QHat = DivideWide(UN[J + VCount], UN[J + VCount - 1], DivisorTop, &RHat);
+        }
+
+        while (!RHatOverflowed)
+        {
+            uint64_t ProductHigh = 0;
+            uint64_t ProductLow = MultiplyWithHigh(QHat, DivisorNext, &ProductHigh);
+            if (ProductHigh < RHat || (ProductHigh == RHat && ProductLow <= UN[J + VCount - 2])) { break; }
+            BIGINT_COUNT_LOOP(BigintLoop_QuotientCorrections, 1);
+            --QHat;
+            RHat += DivisorTop;
+            RHatOverflowed = RHat < DivisorTop;
+        }
+
+        // Multiply and subtract QHat * VN from the current window of UN.
+        uint64_t MultiplyCarry = 0;
+        uint8_t Borrow = 0;
+        for (int32_t I = 0; I < VCount; ++I)
+        {
+            uint64_t High = 0;
+            uint64_t Low = MultiplyWithHigh(QHat, VN[I], &High);
+            Low += MultiplyCarry;
+            MultiplyCarry = High + (Low < MultiplyCarry);
+            Borrow = SubtractWithBorrow(Borrow, UN[I + J], Low, &UN[I + J]);
+        }
+        Borrow = SubtractWithBorrow(Borrow, UN[J + VCount], MultiplyCarry, &UN[J + VCount]);
+
+        // The estimate was one too large (rare): add the divisor back.
+        if (Borrow)
+        {
+            BIGINT_COUNT_LOOP(BigintLoop_AddBacks, 1);
+            --QHat;
+            uint8_t Carry = 0;
+            for (int32_t I = 0; I < VCount; ++I)
+            {
+                Carry = AddWithCarry(Carry, UN[I + J], VN[I], &UN[I + J]);
+            }
+            UN[J + VCount] += Carry;
+        }
+        Quotient[J] = QHat;
+    }
+
+    // Denormalize the remainder.
+    if (Shift == 0)
+    {
+        for (int32_t I = 0; I < VCount; ++I) { Remainder[I] = UN[I]; }
+    }
+    else
+    {
+        for (int32_t I = 0; I < VCount; ++I) { Remainder[I] = (UN[I] >> Shift) | (UN[I + 1] << (64 - Shift)); }
+    }
+}
+
+// Computes *Result = A + B and returns the carry out of the top limb
+// (1 if the true sum does not fit in Bits bits).
+template <uint32_t Bits>
+constexpr uint8_t
+UIntAdd(uintn<Bits>* Result, const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    return AddLimbs<uintn<Bits>::PartCount>(Result->Parts, A.Parts, B.Parts);
+}
+
+// Computes *Result = A - B and returns the borrow out of the top limb
+// (1 if B > A, in which case the result has wrapped around).
+template <uint32_t Bits>
+constexpr uint8_t
+UIntSubtract(uintn<Bits>* Result, const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    return SubtractLimbs<uintn<Bits>::PartCount>(Result->Parts, A.Parts, B.Parts);
+}
+
+// IN-PLACE OPERATORS:
+// The compound operators work on the left operand's parts directly and are the
+// primitives; the two-operand forms copy the left operand once and apply them.
+// Everything takes references, so no 64-byte (or wider) copies are made just to
+// pass an argument.
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator+=(uintn<Bits>& A, const typename uintn_operand<Bits>::type& B)
+{
+    BIGINT_COUNT_OP(BigintOp_Add, A, B);
+    AddLimbs<uintn<Bits>::PartCount>(A.Parts, A.Parts, B.Parts);
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator-=(uintn<Bits>& A, const typename uintn_operand<Bits>::type& B)
+{
+    BIGINT_COUNT_OP(BigintOp_Subtract, A, B);
+    SubtractLimbs<uintn<Bits>::PartCount>(A.Parts, A.Parts, B.Parts);
+    return A;
+}
+
+// Single-part forms: the carry or borrow usually dies in the first part, so
+// stop as soon as it does.
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator+=(uintn<Bits>& A, uint64_t B)
+{
+    BIGINT_COUNT_OP(BigintOp_Add, A, B);
+    uint8_t Carry = AddWithCarry(0, A.Parts[0], B, &A.Parts[0]);
+    for (int32_t PartIndex = 1; Carry && PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        Carry = AddWithCarry(Carry, A.Parts[PartIndex], 0, &A.Parts[PartIndex]);
+    }
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator-=(uintn<Bits>& A, uint64_t B)
+{
+    BIGINT_COUNT_OP(BigintOp_Subtract, A, B);
+    uint8_t Borrow = SubtractWithBorrow(0, A.Parts[0], B, &A.Parts[0]);
+    for (int32_t PartIndex = 1; Borrow && PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        Borrow = SubtractWithBorrow(Borrow, A.Parts[PartIndex], 0, &A.Parts[PartIndex]);
+    }
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator+(const uintn<Bits>& A, const typename uintn_operand<Bits>::type& B)
+{
+    uintn<Bits> Result = A;
+    Result += B;
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr bool
+operator<(const uintn<Bits>& Left, uint64_t Right)
+{
+    BIGINT_COUNT_OP(BigintOp_Less, Left, Right);
+    if (Left.Parts[0] >= Right) { return false; }
+    if (!BigPartEqualsZero(Left)) { return false; }
+    return true;
+}
+
+template <uint32_t Bits>
+constexpr bool
+operator<(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right)
+{
+    BIGINT_COUNT_OP(BigintOp_Less, Left, Right);
+    UINTN_UNROLL
+    for (int32_t PartIndex = uintn<Bits>::PartCount - 1; 
+        PartIndex >= 0; 
+        --PartIndex)
+    {
+        if (Left.Parts[PartIndex] < Right.Parts[PartIndex])
+            return true;
+        else if (Left.Parts[PartIndex] > Right.Parts[PartIndex])
+            return false;
+    }
+
+    return false; // Equal
+}
+
+// Any upper part set makes Left the larger; otherwise the low parts decide.
+template <uint32_t Bits>
+constexpr bool
+operator>(const uintn<Bits>& Left, uint64_t Right)
+{
+    BIGINT_COUNT_OP(BigintOp_Less, Left, Right);
+    if (!BigPartEqualsZero(Left)) { return true; }
+    return Left.Parts[0] > Right;
+}
+
+template <uint32_t Bits>
+constexpr bool
+operator==(const uintn<Bits>& Left, uint64_t Right)
+{
+    BIGINT_COUNT_OP(BigintOp_Equal, Left, Right);
+    if (!BigPartEqualsZero(Left)) { return false; }
+    return Left.Parts[0] == Right;
+}
+
+template <uint32_t Bits>
+constexpr bool
+operator==(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right)
+{
+    BIGINT_COUNT_OP(BigintOp_Equal, Left, Right);
+    uint64_t Difference = 0;
+    UINTN_UNROLL
+    for (int32_t PartIndex = 0;
+        PartIndex < uintn<Bits>::PartCount;
+        ++PartIndex)
+    {
+        Difference |= Left.Parts[PartIndex] ^ Right.Parts[PartIndex];
+    }
+    return Difference == 0;
+}
+
+template <uint32_t Bits> constexpr bool
+operator!=(const uintn<Bits>& Left, uint64_t Right) { return !(Left == Right); }
+template <uint32_t Bits> constexpr bool
+operator<=(const uintn<Bits>& Left, uint64_t Right) { return !(Left > Right); }
+template <uint32_t Bits> constexpr bool
+operator>=(const uintn<Bits>& Left, uint64_t Right) { return !(Left < Right); }
+
+template <uint32_t Bits> constexpr bool
+operator!=(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right) { return !(Left == Right); }
+template <uint32_t Bits> constexpr bool
+operator>(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right) { return Right < Left; }
+template <uint32_t Bits> constexpr bool
+operator<=(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right) { return !(Right < Left); }
+template <uint32_t Bits> constexpr bool
+operator>=(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right) { return !(Left < Right); }
+
+// Shifts by any distance in one pass: whole parts move by Shift / 64 and the
+// remaining Shift % 64 bits are funnelled in from the neighbouring part. Bits
+// shifted past either end are lost, so a Shift of Bits or more gives 0.
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator<<=(uintn<Bits>& A, uint32_t Shift)
+{
+    BIGINT_COUNT_UNARY(BigintOp_ShiftLeft, A);
+    // Top down, so every source part is read before it is overwritten.
+    const int32_t Count = uintn<Bits>::PartCount;
+    int32_t PartShift = (Shift >= Bits) ? Count : (int32_t)(Shift / 64);
+    uint32_t BitShift = Shift % 64;
+    UINTN_UNROLL
+    for (int32_t PartIndex = Count - 1; PartIndex >= 0; --PartIndex)
+    {
+        int32_t Source = PartIndex - PartShift;
+        uint64_t High = (Source >= 0) ? A.Parts[Source] : 0;
+        uint64_t Low = (Source >= 1) ? A.Parts[Source - 1] : 0;
+        A.Parts[PartIndex] = (BitShift == 0) ? High : (High << BitShift) | (Low >> (64 - BitShift));
+    }
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator>>=(uintn<Bits>& A, uint32_t Shift)
+{
+    BIGINT_COUNT_UNARY(BigintOp_ShiftRight, A);
+    // Bottom up, for the same reason.
+    const int32_t Count = uintn<Bits>::PartCount;
+    int32_t PartShift = (Shift >= Bits) ? Count : (int32_t)(Shift / 64);
+    uint32_t BitShift = Shift % 64;
+    UINTN_UNROLL
+    for (int32_t PartIndex = 0; PartIndex < Count; ++PartIndex)
+    {
+        int32_t Source = PartIndex + PartShift;
+        uint64_t Low = (Source < Count) ? A.Parts[Source] : 0;
+        uint64_t High = (Source + 1 < Count) ? A.Parts[Source + 1] : 0;
+        A.Parts[PartIndex] = (BitShift == 0) ? Low : (Low >> BitShift) | (High << (64 - BitShift));
+    }
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator<<(const uintn<Bits>& A, uint32_t Shift)
+{
+    uintn<Bits> Result = A;
+    Result <<= Shift;
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator>>(const uintn<Bits>& A, uint32_t Shift)
+{
+    uintn<Bits> Result = A;
+    Result >>= Shift;
+    return Result;
+}
+
+// Full-width product: all 2 * Bits bits of A * B.
+template <uint32_t Bits>
+constexpr uintn<2 * Bits>
+UIntMultiplyWide(const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    BIGINT_COUNT_OP(BigintOp_MultiplyWide, A, B);
+    const int32_t Count = uintn<Bits>::PartCount;
+    uintn<2 * Bits> Result;
+    limb_multiply<Count>::Wide(Result.Parts, A.Parts, B.Parts);
+    return Result;
+}
+
+// Full-width square, roughly half the partial products of UIntMultiplyWide(A, A).
+template <uint32_t Bits>
+constexpr uintn<2 * Bits>
+UIntSquare(const uintn<Bits>& A)
+{
+    BIGINT_COUNT_UNARY(BigintOp_Square, A);
+    const int32_t Count = uintn<Bits>::PartCount;
+    uintn<2 * Bits> Result;
+    limb_multiply<Count>::Square(Result.Parts, A.Parts);
+    return Result;
+}
+
+// Truncated product: the low Bits bits of A * B. The product kernels cannot
+// write over their inputs, so this is the primitive and *= goes through it.
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator*(const uintn<Bits>& A, const typename uintn_operand<Bits>::type& B)
+{
+    BIGINT_COUNT_OP(BigintOp_Multiply, A, B);
+    const int32_t Count = uintn<Bits>::PartCount;
+    uintn<Bits> Result;
+    limb_multiply<Count>::Low(Result.Parts, A.Parts, B.Parts);
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator*=(uintn<Bits>& A, const typename uintn_operand<Bits>::type& B)
+{
+    A = A * B;
+    return A;
+}
+
+// A += B * C, keeping the low Bits bits, with each row of partial products
+// added straight into A instead of building the product first. A must not
+// alias B or C. From the Karatsuba threshold up the split product is cheaper
+// than the rows it saves, so it is formed first and added.
+template <uint32_t Bits>
+constexpr void
+UIntAddMul(uintn<Bits>* A, const uintn<Bits>& B, const uintn<Bits>& C)
+{
+    const int32_t Count = uintn<Bits>::PartCount;
+    BIGINT_COUNT_OP(BigintOp_AddMul, B, C);
+    if (Count >= BIGINT_KARATSUBA_THRESHOLD)
+    {
+        *A += B * C;
+        return;
+    }
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, Count * (Count + 1) / 2);
+    for (int32_t Row = 0; Row < Count; ++Row)
+    {
+        uint64_t Carry = 0;
+        UINTN_UNROLL
+        for (int32_t Column = 0; Column < Count - Row; ++Column)
+        {
+            A->Parts[Row + Column] = MultiplyAddWithCarry(B.Parts[Row], C.Parts[Column], A->Parts[Row + Column], &Carry);
+        }
+    }
+}
+
+// A += B * C for a single part C. Returns the part carried out of the top, so
+// nothing is lost. A may alias B.
+template <uint32_t Bits>
+constexpr uint64_t
+UIntAddMul(uintn<Bits>* A, const uintn<Bits>& B, uint64_t C)
+{
+    BIGINT_COUNT_OP(BigintOp_AddMul, B, C);
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, uintn<Bits>::PartCount);
+    uint64_t Carry = 0;
+    UINTN_UNROLL
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        A->Parts[PartIndex] = MultiplyAddWithCarry(B.Parts[PartIndex], C, A->Parts[PartIndex], &Carry);
+    }
+    return Carry;
+}
+
+// N = N * Multiplier + Addend. Returns the part carried out of the top, which
+// is non-zero exactly when the result does not fit.
+template <uint32_t Bits>
+constexpr uint64_t
+UIntMultiplyAddPart(uintn<Bits>* N, uint64_t Multiplier, uint64_t Addend)
+{
+    BIGINT_COUNT_OP(BigintOp_AddMul, *N, Multiplier);
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, uintn<Bits>::PartCount);
+    uint64_t Carry = Addend;
+    UINTN_UNROLL
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        N->Parts[PartIndex] = MultiplyAddWithCarry(N->Parts[PartIndex], Multiplier, 0, &Carry);
+    }
+    return Carry;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator-(const uintn<Bits>& Left, const typename uintn_operand<Bits>::type& Right)
+{
+    uintn<Bits> Result = Left;
+    Result -= Right;
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator-(const uintn<Bits>& A)
+{
+    uintn<Bits> Result = 0;
+    Result -= A;
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr bool
+GetBitAt(const uintn<Bits>& A, uint32_t Place)
+{
+    assert(Place < Bits); // Zero-indexed
+    int Part = Place / 64;
+    int PartPlace = Place % 64;
+    return (A.Parts[Part] >> PartPlace) & 1;
+}
+
+template <uint32_t Bits>
+constexpr void
+SetBitAt(uintn<Bits>* A, uint32_t Place, bool Value)
+{
+    assert(Place < Bits); // Zero-indexed
+    int Part = Place / 64;
+    int PartPlace = Place % 64;
+    uint64_t BitValue = (A->Parts[Part] >> PartPlace) & 1;
+    if (Value) { BitValue = !BitValue; }
+    // If XOR'd with itself, will be zero (false)
+    // If XOR'd with its negation, will be one (true)
+    A->Parts[Part] ^= BitValue << PartPlace;
+}
+
+template <uint32_t Bits>
+struct uintn_division_result
+{
+    uintn<Bits> Quotient;
+    uintn<Bits> Remainder;
+};
+
+typedef uintn_division_result<512> uint512_divison_result;
+
+// Number of parts up to and including the most significant non-zero one.
+template <uint32_t Bits>
+constexpr int32_t
+SignificantPartCount(const uintn<Bits>& A)
+{
+    int32_t Result = uintn<Bits>::PartCount;
+    while (Result > 0 && A.Parts[Result - 1] == 0) { --Result; }
+    return Result;
+}
+
+// Bit length: number of significant bits in A (0 for A == 0). One part scan
+// plus a single lzcnt.
+template <uint32_t Bits>
+constexpr uint32_t
+SignificantBitCount(const uintn<Bits>& A)
+{
+    int32_t PartCount = SignificantPartCount(A);
+    if (PartCount == 0) { return 0; }
+    return 64 * PartCount - CountLeadingZeros64(A.Parts[PartCount - 1]);
+}
+
+// Zero bits above the most significant set bit (Bits for A == 0).
+template <uint32_t Bits>
+constexpr uint32_t
+LeadingZeroBitCount(const uintn<Bits>& A)
+{
+    return Bits - SignificantBitCount(A);
+}
+
+// Zero bits below the least significant set bit (Bits for A == 0).
+template <uint32_t Bits>
+constexpr uint32_t
+TrailingZeroBitCount(const uintn<Bits>& A)
+{
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        if (A.Parts[PartIndex] != 0) { return 64 * PartIndex + CountTrailingZeros64(A.Parts[PartIndex]); }
+    }
+    return Bits;
+}
+
+// Fast path for divisors that fit in one part: a single pass of hardware divides
+// over the parts A actually uses (zero parts above them divide to zero).
+template <uint32_t Bits>
+constexpr uintn<Bits>
+UIntDivideByPart(const uintn<Bits>& A, uint64_t Divisor, uint64_t* Remainder)
+{
+    assert(Divisor != 0);
+    BIGINT_COUNT_OP(BigintOp_DivideByPart, A, Divisor);
+    uintn<Bits> Quotient;
+    *Remainder = DivideLimbsBySingle(Quotient.Parts, A.Parts, SignificantPartCount(A), Divisor);
+    return Quotient;
+}
+
+// A % Divisor using the precomputed reciprocal. The normalizing shift is applied
+// to A on the fly, one part at a time.
+template <uint32_t Bits>
+constexpr uint64_t
+UIntRemainderByPart(const uintn<Bits>& A, const part_divisor* Divisor)
+{
+    BIGINT_COUNT_OP(BigintOp_RemainderByPart, A, Divisor->Normalized >> Divisor->Shift);
+    const int32_t Count = uintn<Bits>::PartCount;
+    uint32_t Shift = Divisor->Shift;
+    uint64_t Remainder = 0;
+    if (Shift == 0)
+    {
+        UINTN_UNROLL
+        for (int32_t PartIndex = Count - 1; PartIndex >= 0; --PartIndex)
+        {
+            Remainder = RemainderWidePreinverted(Remainder, A.Parts[PartIndex], Divisor);
+        }
+        return Remainder;
+    }
+
+    Remainder = A.Parts[Count - 1] >> (64 - Shift);
+    UINTN_UNROLL
+    for (int32_t PartIndex = Count - 1; PartIndex >= 0; --PartIndex)
+    {
+        uint64_t Part = A.Parts[PartIndex] << Shift;
+        if (PartIndex > 0) { Part |= A.Parts[PartIndex - 1] >> (64 - Shift); }
+        Remainder = RemainderWidePreinverted(Remainder, Part, Divisor);
+    }
+    return Remainder >> Shift;
+}
+
+// Long division computing A / B and A % B together (Knuth Algorithm D),
+// with the single-part divisor fast path.
+template <uint32_t Bits>
+constexpr uintn_division_result<Bits>
+UIntDivision(const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    assert(B != 0);
+    BIGINT_COUNT_OP(BigintOp_Division, A, B);
+    // The part counts settle most cases without a full-width compare: fewer
+    // parts means smaller, and one part each is a native divide.
+    int32_t DividendCount = SignificantPartCount(A);
+    int32_t DivisorCount = SignificantPartCount(B);
+    if (DividendCount < DivisorCount || (DividendCount == DivisorCount && A < B))
+    {
+        uintn_division_result<Bits> Result = { 0, A };
+        return Result;
+    }
+    if (DividendCount == 1)
+    {
+        uintn_division_result<Bits> Result = { A.Parts[0] / B.Parts[0], A.Parts[0] % B.Parts[0] };
+        return Result;
+    }
+    if (DivisorCount == 1)
+    {
+        uint64_t Remainder = 0;
+        uintn<Bits> Quotient;
+        Remainder = DivideLimbsBySingle(Quotient.Parts, A.Parts, DividendCount, B.Parts[0]);
+        uintn_division_result<Bits> Result = { Quotient, Remainder };
+        return Result;
     }
+
+    uintn_division_result<Bits> Result = { 0, 0 };
+    uint64_t Scratch[2 * uintn<Bits>::PartCount + 1] = {};
+    DivideLimbs(Result.Quotient.Parts, Result.Remainder.Parts,
+                A.Parts, DividendCount, B.Parts, DivisorCount, Scratch);
     return Result;
 }
 
-inline uint512::uint512()
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator/(const uintn<Bits>& N, const typename uintn_operand<Bits>::type& D)
 {
+    BIGINT_COUNT_OP(BigintOp_Divide, N, D);
+    uintn_division_result<Bits> Result = UIntDivision(N, D);
+    return Result.Quotient;
 }
 
-inline uint512::uint512(int C)
+template <uint32_t Bits>
+constexpr uintn<Bits>
+operator%(const uintn<Bits>& N, const typename uintn_operand<Bits>::type& D)
 {
-    ZeroMemory(this->Parts, sizeof(this->Parts));
-    this->Parts[0] = C;
+    BIGINT_COUNT_OP(BigintOp_Modulo, N, D);
+    uintn_division_result<Bits> Result = UIntDivision(N, D);
+    return Result.Remainder;
 }
 
-inline uint512::uint512(uint C)
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator/=(uintn<Bits>& N, const typename uintn_operand<Bits>::type& D)
 {
-    ZeroMemory(this->Parts, sizeof(this->Parts));
-    this->Parts[0] = C;
+    BIGINT_COUNT_OP(BigintOp_Divide, N, D);
+    N = UIntDivision(N, D).Quotient;
+    return N;
 }
 
-inline uint512::uint512(uint64_t C)
+template <uint32_t Bits>
+constexpr uintn<Bits>&
+operator%=(uintn<Bits>& N, const typename uintn_operand<Bits>::type& D)
 {
-    ZeroMemory(this->Parts, sizeof(this->Parts));
-    this->Parts[0] = C & 0xFFFFFFFF;
-    this->Parts[1] = (C >> 32) & 0xFFFFFFFF;
+    BIGINT_COUNT_OP(BigintOp_Modulo, N, D);
+    N = UIntDivision(N, D).Remainder;
+    return N;
 }
 
-inline uint512::uint512(uint32_t Parts[16])
+// Value of one hex digit in either case, or 16 for anything else.
+constexpr uint64_t
+HexDigitValue(char Character)
 {
-    CopyMemory(this->Parts, Parts, sizeof(Parts));
+    uint64_t Digit = (uint64_t)(uint8_t)Character - '0';
+    if (Digit < 10) { return Digit; }
+    Digit = ((uint64_t)(uint8_t)Character | 0x20) - 'a';
+    return (Digit < 6) ? Digit + 10 : 16;
 }
 
-bool BigPartEqualsZero(uint512 A)
+// LITERALS:
+// 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF_u256 and
+// friends. These are raw literal operators, so they see the digits as written
+// and any length parses without passing through unsigned long long. Decimal,
+// 0x hex, 0b binary and leading-zero octal are accepted, with ' separators.
+// Declared constexpr, the value is built entirely at compile time, and one that
+// does not fit fails to compile (the assert is not a constant expression).
+template <uint32_t Bits>
+constexpr uintn<Bits>
+UIntParseLiteral(const char* Text)
 {
-    return (A.Parts[1] | A.Parts[2] | A.Parts[3] | A.Parts[4] |
-            A.Parts[5] | A.Parts[6] | A.Parts[7] | A.Parts[8] |
-            A.Parts[9] | A.Parts[10] | A.Parts[11] | A.Parts[12] |
-            A.Parts[13] | A.Parts[14] | A.Parts[15]) == 0;
+    uint64_t Base = 10;
+    if (Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X')) { Base = 16; Text += 2; }
+    else if (Text[0] == '0' && (Text[1] == 'b' || Text[1] == 'B')) { Base = 2; Text += 2; }
+    else if (Text[0] == '0') { Base = 8; }
+
+    uintn<Bits> Result = 0;
+    for (; *Text; ++Text)
+    {
+        if (*Text == '\'') { continue; }
+        uint64_t Digit = HexDigitValue(*Text);
+        assert(Digit < Base && "invalid digit in uintn literal");
+        uint64_t Overflow = UIntMultiplyAddPart(&Result, Base, Digit);
+        assert(Overflow == 0 && "uintn literal does not fit");
+        (void)Overflow;
+    }
+    return Result;
 }
 
-bool Unsigned32AdditionOverflows(uint32_t A, uint32_t B)
+constexpr uint256 operator""_u256(const char* Text) { return UIntParseLiteral<256>(Text); }
+constexpr uint512 operator""_u512(const char* Text) { return UIntParseLiteral<512>(Text); }
+constexpr uint1024 operator""_u1024(const char* Text) { return UIntParseLiteral<1024>(Text); }
+
+// ACTIVE-PART TRACKING:
+// uintn_tracked carries the number of significant parts next to the value, so
+// counters, witnesses, small quotients and remainders that live in the low one
+// or two parts do not pay for the full width. Add, subtract, compare, multiply
+// and divide loop over the active parts only, and drop to native 64-bit
+// arithmetic when both sides fit in one part. Dense full-width values are
+// better off as plain uintn: every operation here pays a branch or two to
+// keep ActiveCount exact.
+template <uint32_t Bits>
+struct uintn_tracked
+{
+    uintn<Bits> Value;
+    int32_t ActiveCount;  // SignificantPartCount(Value); every part from here up is zero
+
+    constexpr uintn_tracked() : Value(), ActiveCount(0) {}
+    constexpr uintn_tracked(int C) : Value(C), ActiveCount(C != 0) {}
+    constexpr uintn_tracked(uint C) : Value(C), ActiveCount(C != 0) {}
+    constexpr uintn_tracked(unsigned long C) : Value(C), ActiveCount(C != 0) {}
+    constexpr uintn_tracked(unsigned long long C) : Value(C), ActiveCount(C != 0) {}
+    constexpr uintn_tracked(const uintn<Bits>& A) : Value(A), ActiveCount(SignificantPartCount(A)) {}
+};
+
+typedef uintn_tracked<256> uint256_tracked;
+typedef uintn_tracked<512> uint512_tracked;
+
+template <uint32_t Bits>
+struct uintn_tracked_operand
+{
+    typedef uintn_tracked<Bits> type;
+};
+
+// Sets ActiveCount after an operation that leaves every part from UpperBound up
+// zero.
+template <uint32_t Bits>
+constexpr void
+UIntTrackedTrim(uintn_tracked<Bits>* A, int32_t UpperBound)
 {
-    return UINT32_MAX - A < B;
+    while (UpperBound > 0 && A->Value.Parts[UpperBound - 1] == 0) { --UpperBound; }
+    A->ActiveCount = UpperBound;
 }
 
-inline uint512
-operator+(uint512 A, uint512 B)
+// Result = A + B over the low Count parts; returns the carry out of part
+// Count - 1. Full-width operands get the unrolled AddLimbs chain.
+template <uint32_t Bits>
+constexpr uint8_t
+UIntTrackedAddParts(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t Count)
 {
-    uint512 Result = 0;
-    bool OverflowedLastPart = false;
-    for (int32_t PartIndex = 0; 
-        PartIndex < UINT512_PARTS; 
-        ++PartIndex)
+    if (Count == uintn<Bits>::PartCount) { return AddLimbs<uintn<Bits>::PartCount>(Result, A, B); }
+    uint8_t Carry = 0;
+    for (int32_t PartIndex = 0; PartIndex < Count; ++PartIndex)
+    {
+        Carry = AddWithCarry(Carry, A[PartIndex], B[PartIndex], &Result[PartIndex]);
+    }
+    return Carry;
+}
+
+template <uint32_t Bits>
+constexpr uint8_t
+UIntTrackedSubtractParts(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t Count)
+{
+    if (Count == uintn<Bits>::PartCount) { return SubtractLimbs<uintn<Bits>::PartCount>(Result, A, B); }
+    uint8_t Borrow = 0;
+    for (int32_t PartIndex = 0; PartIndex < Count; ++PartIndex)
+    {
+        Borrow = SubtractWithBorrow(Borrow, A[PartIndex], B[PartIndex], &Result[PartIndex]);
+    }
+    return Borrow;
+}
+
+// Finishes an add over Count parts: the carry, if any, becomes a new top part.
+template <uint32_t Bits>
+constexpr void
+UIntTrackedFinishAdd(uintn_tracked<Bits>* Result, int32_t Count, uint8_t Carry)
+{
+    if (Carry && Count < uintn<Bits>::PartCount) { Result->Value.Parts[Count++] = 1; }
+    UIntTrackedTrim(Result, Count);
+}
+
+// Finishes a subtract over Count parts. Wraps mod 2^Bits like uintn: when
+// B > A the borrow runs through the zero parts above and the result is full
+// width.
+template <uint32_t Bits>
+constexpr void
+UIntTrackedFinishSubtract(uintn_tracked<Bits>* Result, int32_t Count, uint8_t Borrow)
+{
+    if (Borrow)
     {
-        Result.Parts[PartIndex] += A.Parts[PartIndex] + B.Parts[PartIndex];
-        if (OverflowedLastPart) { Result.Parts[PartIndex] += 1; }
+        for (; Count < uintn<Bits>::PartCount; ++Count) { Result->Value.Parts[Count] = 0xFFFFFFFFFFFFFFFF; }
+    }
+    UIntTrackedTrim(Result, Count);
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator+=(uintn_tracked<Bits>& A, const typename uintn_tracked_operand<Bits>::type& B)
+{
+    BIGINT_COUNT_OP(BigintOp_Add, A.Value, B.Value);
+    int32_t Count = (A.ActiveCount > B.ActiveCount) ? A.ActiveCount : B.ActiveCount;
+    uint8_t Carry = UIntTrackedAddParts<Bits>(A.Value.Parts, A.Value.Parts, B.Value.Parts, Count);
+    UIntTrackedFinishAdd(&A, Count, Carry);
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator-=(uintn_tracked<Bits>& A, const typename uintn_tracked_operand<Bits>::type& B)
+{
+    BIGINT_COUNT_OP(BigintOp_Subtract, A.Value, B.Value);
+    int32_t Count = (A.ActiveCount > B.ActiveCount) ? A.ActiveCount : B.ActiveCount;
+    uint8_t Borrow = UIntTrackedSubtractParts<Bits>(A.Value.Parts, A.Value.Parts, B.Value.Parts, Count);
+    UIntTrackedFinishSubtract(&A, Count, Borrow);
+    return A;
+}
+
+// The two-operand forms start from zero and write only the active parts,
+// rather than copying all of A first.
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator+(const uintn_tracked<Bits>& A, const typename uintn_tracked_operand<Bits>::type& B)
+{
+    uintn_tracked<Bits> Result;
+    int32_t Count = (A.ActiveCount > B.ActiveCount) ? A.ActiveCount : B.ActiveCount;
+    uint8_t Carry = UIntTrackedAddParts<Bits>(Result.Value.Parts, A.Value.Parts, B.Value.Parts, Count);
+    UIntTrackedFinishAdd(&Result, Count, Carry);
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator-(const uintn_tracked<Bits>& A, const typename uintn_tracked_operand<Bits>::type& B)
+{
+    uintn_tracked<Bits> Result;
+    int32_t Count = (A.ActiveCount > B.ActiveCount) ? A.ActiveCount : B.ActiveCount;
+    uint8_t Borrow = UIntTrackedSubtractParts<Bits>(Result.Value.Parts, A.Value.Parts, B.Value.Parts, Count);
+    UIntTrackedFinishSubtract(&Result, Count, Borrow);
+    return Result;
+}
 
-        if (Unsigned32AdditionOverflows(A.Parts[PartIndex], B.Parts[PartIndex]) ||
-            (OverflowedLastPart && Unsigned32AdditionOverflows(A.Parts[PartIndex] + B.Parts[PartIndex], 1)))
+// More active parts is larger; only equal counts need a part scan, and that
+// starts at the top active part.
+template <uint32_t Bits>
+constexpr bool
+operator<(const uintn_tracked<Bits>& Left, const typename uintn_tracked_operand<Bits>::type& Right)
+{
+    if (Left.ActiveCount != Right.ActiveCount) { return Left.ActiveCount < Right.ActiveCount; }
+    for (int32_t PartIndex = Left.ActiveCount - 1; PartIndex >= 0; --PartIndex)
+    {
+        if (Left.Value.Parts[PartIndex] != Right.Value.Parts[PartIndex])
         {
-            OverflowedLastPart = true;
+            return Left.Value.Parts[PartIndex] < Right.Value.Parts[PartIndex];
         }
-        else
+    }
+    return false;
+}
+
+template <uint32_t Bits>
+constexpr bool
+operator==(const uintn_tracked<Bits>& Left, const typename uintn_tracked_operand<Bits>::type& Right)
+{
+    if (Left.ActiveCount != Right.ActiveCount) { return false; }
+    for (int32_t PartIndex = 0; PartIndex < Left.ActiveCount; ++PartIndex)
+    {
+        if (Left.Value.Parts[PartIndex] != Right.Value.Parts[PartIndex]) { return false; }
+    }
+    return true;
+}
+
+template <uint32_t Bits> constexpr bool
+operator!=(const uintn_tracked<Bits>& Left, const typename uintn_tracked_operand<Bits>::type& Right) { return !(Left == Right); }
+template <uint32_t Bits> constexpr bool
+operator>(const uintn_tracked<Bits>& Left, const typename uintn_tracked_operand<Bits>::type& Right) { return Right < Left; }
+template <uint32_t Bits> constexpr bool
+operator<=(const uintn_tracked<Bits>& Left, const typename uintn_tracked_operand<Bits>::type& Right) { return !(Right < Left); }
+template <uint32_t Bits> constexpr bool
+operator>=(const uintn_tracked<Bits>& Left, const typename uintn_tracked_operand<Bits>::type& Right) { return !(Left < Right); }
+
+// Truncated product. Operands whose active parts together fit in the width
+// take one row of partial products per active part of A (one part each is a
+// single 64x64 -> 128 multiply); wider ones go to the full-width kernels, which
+// are the better choice there (Karatsuba included).
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator*(const uintn_tracked<Bits>& A, const typename uintn_tracked_operand<Bits>::type& B)
+{
+    const int32_t Count = uintn<Bits>::PartCount;
+    uintn_tracked<Bits> Result;
+    if (A.ActiveCount == 0 || B.ActiveCount == 0) { return Result; }
+    if (A.ActiveCount + B.ActiveCount > Count)
+    {
+        Result.Value = A.Value * B.Value;
+        UIntTrackedTrim(&Result, Count);
+        return Result;
+    }
+    BIGINT_COUNT_OP(BigintOp_Multiply, A.Value, B.Value);
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, A.ActiveCount * B.ActiveCount);
+    for (int32_t Row = 0; Row < A.ActiveCount; ++Row)
+    {
+        uint64_t Carry = 0;
+        for (int32_t Column = 0; Column < B.ActiveCount; ++Column)
         {
-            OverflowedLastPart = false;
+            Result.Value.Parts[Row + Column] = MultiplyAddWithCarry(A.Value.Parts[Row], B.Value.Parts[Column],
+                                                                    Result.Value.Parts[Row + Column], &Carry);
         }
+        Result.Value.Parts[Row + B.ActiveCount] = Carry;
     }
+    UIntTrackedTrim(&Result, A.ActiveCount + B.ActiveCount);
     return Result;
 }
 
-inline bool
-operator<(uint512 Left, uint Right)
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator*=(uintn_tracked<Bits>& A, const typename uintn_tracked_operand<Bits>::type& B)
 {
-    if (Left.Parts[0] >= Right) { return false; }
-    if (!BigPartEqualsZero(Left)) { return false; }
-    return true;
+    A = A * B;
+    return A;
 }
 
-inline bool
-operator<(uint512 Left, uint512 Right)
+template <uint32_t Bits>
+struct uintn_tracked_division_result
 {
-    for (int32_t PartIndex = UINT512_PARTS - 1; 
-        PartIndex >= 0; 
-        --PartIndex)
+    uintn_tracked<Bits> Quotient;
+    uintn_tracked<Bits> Remainder;
+};
+
+// UIntDivision with the part counts already known: no scans, a native divide
+// when the dividend has one part, and Algorithm D over the active parts only.
+template <uint32_t Bits>
+constexpr uintn_tracked_division_result<Bits>
+UIntTrackedDivision(const uintn_tracked<Bits>& A, const uintn_tracked<Bits>& B)
+{
+    assert(B.ActiveCount != 0);
+    BIGINT_COUNT_OP(BigintOp_Division, A.Value, B.Value);
+    uintn_tracked_division_result<Bits> Result;
+    if (A < B)
     {
-        if (Left.Parts[PartIndex] < Right.Parts[PartIndex])
-            return true;
-        else if (Left.Parts[PartIndex] > Right.Parts[PartIndex])
-            return false;
+        Result.Remainder = A;
+        return Result;
+    }
+    if (A.ActiveCount == 1)
+    {
+        Result.Quotient = A.Value.Parts[0] / B.Value.Parts[0];
+        Result.Remainder = A.Value.Parts[0] % B.Value.Parts[0];
+        return Result;
+    }
+    if (B.ActiveCount == 1)
+    {
+        Result.Remainder = DivideLimbsBySingle(Result.Quotient.Value.Parts, A.Value.Parts, A.ActiveCount, B.Value.Parts[0]);
+        UIntTrackedTrim(&Result.Quotient, A.ActiveCount);
+        return Result;
     }
+    uint64_t Scratch[2 * uintn<Bits>::PartCount + 1] = {};
+    DivideLimbs(Result.Quotient.Value.Parts, Result.Remainder.Value.Parts,
+                A.Value.Parts, A.ActiveCount, B.Value.Parts, B.ActiveCount, Scratch);
+    UIntTrackedTrim(&Result.Quotient, A.ActiveCount - B.ActiveCount + 1);
+    UIntTrackedTrim(&Result.Remainder, B.ActiveCount);
+    return Result;
+}
 
-    return false; // Equal
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator/(const uintn_tracked<Bits>& N, const typename uintn_tracked_operand<Bits>::type& D)
+{
+    return UIntTrackedDivision(N, D).Quotient;
 }
 
-inline bool
-operator==(uint512 Left, uint Right)
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator%(const uintn_tracked<Bits>& N, const typename uintn_tracked_operand<Bits>::type& D)
 {
-    if (!BigPartEqualsZero(Left)) { return false; }
-    return Left.Parts[0] == Right;
+    return UIntTrackedDivision(N, D).Remainder;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator/=(uintn_tracked<Bits>& N, const typename uintn_tracked_operand<Bits>::type& D)
+{
+    N = UIntTrackedDivision(N, D).Quotient;
+    return N;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator%=(uintn_tracked<Bits>& N, const typename uintn_tracked_operand<Bits>::type& D)
+{
+    N = UIntTrackedDivision(N, D).Remainder;
+    return N;
+}
+
+// Shifts move ActiveCount by the whole parts shifted, give or take the one the
+// spare bits spill into.
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator<<=(uintn_tracked<Bits>& A, uint32_t Shift)
+{
+    A.Value <<= Shift;
+    uint64_t UpperBound = (uint64_t)A.ActiveCount + Shift / 64 + 1;
+    UIntTrackedTrim(&A, (UpperBound < (uint64_t)uintn<Bits>::PartCount) ? (int32_t)UpperBound : uintn<Bits>::PartCount);
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>&
+operator>>=(uintn_tracked<Bits>& A, uint32_t Shift)
+{
+    A.Value >>= Shift;
+    int32_t PartShift = (int32_t)(Shift / 64);
+    UIntTrackedTrim(&A, (PartShift < A.ActiveCount) ? A.ActiveCount - PartShift : 0);
+    return A;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator<<(const uintn_tracked<Bits>& A, uint32_t Shift)
+{
+    uintn_tracked<Bits> Result = A;
+    Result <<= Shift;
+    return Result;
+}
+
+template <uint32_t Bits>
+constexpr uintn_tracked<Bits>
+operator>>(const uintn_tracked<Bits>& A, uint32_t Shift)
+{
+    uintn_tracked<Bits> Result = A;
+    Result >>= Shift;
+    return Result;
+}
+
+// Shifts a non-zero A right until it is odd and returns the shift.
+template <uint32_t Bits>
+inline uint32_t
+UIntRemoveTrailingZeros(uintn<Bits>* A)
+{
+    uint32_t Shift = TrailingZeroBitCount(*A);
+    *A = *A >> Shift;
+    return Shift;
+}
+
+// Greatest common divisor by the binary (Stein) method: only subtractions and
+// shifts, with each run of zero bits removed in one count-trailing-zeros step.
+// UIntGCD(A, 0) == A.
+template <uint32_t Bits>
+inline uintn<Bits>
+UIntGCD(uintn<Bits> A, uintn<Bits> B)
+{
+    if (A == 0) { return B; }
+    if (B == 0) { return A; }
+
+    uint32_t ATwos = UIntRemoveTrailingZeros(&A);
+    uint32_t BTwos = UIntRemoveTrailingZeros(&B);
+    uint32_t CommonTwos = (ATwos < BTwos) ? ATwos : BTwos;
+    for (;;)
+    {
+        // Both odd: their difference is even, and halving it keeps the GCD.
+        if (A > B)
+        {
+            uintn<Bits> Swap = A; A = B; B = Swap;
+        }
+        UIntSubtract(&B, B, A);
+        if (B == 0) { break; }
+        UIntRemoveTrailingZeros(&B);
+    }
+
+    return A << CommonTwos;
 }
 
+// X / 2 mod an odd Modulus, for X < Modulus: odd X gets Modulus added first,
+// and the carry out of that sum becomes the new top bit.
+template <uint32_t Bits>
+inline uintn<Bits>
+UIntHalveModular(uintn<Bits> X, uintn<Bits> Modulus)
+{
+    const int32_t Count = uintn<Bits>::PartCount;
+    uint64_t Carry = (X.Parts[0] & 1) ? UIntAdd(&X, X, Modulus) : 0;
+    UINTN_UNROLL
+    for (int32_t PartIndex = 0; PartIndex < Count - 1; ++PartIndex)
+    {
+        X.Parts[PartIndex] = (X.Parts[PartIndex] >> 1) | (X.Parts[PartIndex + 1] << 63);
+    }
+    X.Parts[Count - 1] = (X.Parts[Count - 1] >> 1) | (Carry << 63);
+    return X;
+}
+
+// Binary extended Euclid for an odd Modulus. Invariants: U == X1 * A and
+// V == X2 * A (mod Modulus), while U and V shrink towards their GCD.
+template <uint32_t Bits>
 inline bool
-operator==(uint512 Left, uint512 Right)
+UIntModularInverseOdd(uintn<Bits> A, uintn<Bits> Modulus, uintn<Bits>* Inverse)
 {
-    for (int32_t PartIndex = 0;
-        PartIndex < UINT512_PARTS;
-        ++PartIndex)
+    uintn<Bits> U = A, V = Modulus;
+    uintn<Bits> X1 = 1, X2 = 0;
+    while (U != 1 && V != 1)
     {
-        if (Left.Parts[PartIndex] != Right.Parts[PartIndex]) { return false; }
+        if (U == 0 || V == 0) { return false; } // GCD(A, Modulus) > 1
+        while ((U.Parts[0] & 1) == 0) { U >>= 1; X1 = UIntHalveModular(X1, Modulus); }
+        while ((V.Parts[0] & 1) == 0) { V >>= 1; X2 = UIntHalveModular(X2, Modulus); }
+        if (U >= V)
+        {
+            UIntSubtract(&U, U, V);
+            if (UIntSubtract(&X1, X1, X2)) { UIntAdd(&X1, X1, Modulus); }
+        }
+        else
+        {
+            UIntSubtract(&V, V, U);
+            if (UIntSubtract(&X2, X2, X1)) { UIntAdd(&X2, X2, Modulus); }
+        }
     }
+    *Inverse = (U == 1) ? X1 : X2;
     return true;
 }
 
+// A^-1 mod Modulus (Modulus > 1). Returns false, leaving Inverse untouched, when
+// A and Modulus share a factor. Even moduli (e.g. RSA's lambda(N)) are handled
+// through the odd modulus A: with Y = Modulus^-1 mod A, Modulus * Y == 1 + A * K
+// and the answer is Modulus - K.
+template <uint32_t Bits>
 inline bool
-operator!=(uint512 Left, uint Right) { return !(Right == Left); }
-inline bool
-operator>(uint512 Left, uint Right) { return Right < Left; }
-inline bool
-operator<=(uint512 Left, uint Right) { return !(Left > Right); }
-inline bool
-operator>=(uint512 Left, uint Right) { return !(Left < Right); }
+UIntModularInverse(uintn<Bits> A, uintn<Bits> Modulus, uintn<Bits>* Inverse)
+{
+    assert(Modulus > 1);
+    if (A >= Modulus) { A %= Modulus; }
+    if (Modulus.Parts[0] & 1) { return UIntModularInverseOdd(A, Modulus, Inverse); }
 
-inline bool
-operator!=(uint512 Left, uint512 Right) { return !(Right == Left); }
-inline bool
-operator>(uint512 Left, uint512 Right) { return Right < Left; }
-inline bool
-operator<=(uint512 Left, uint512 Right) { return !(Left > Right); }
-inline bool
-operator>=(uint512 Left, uint512 Right) { return !(Left < Right); }
+    if ((A.Parts[0] & 1) == 0) { return false; }
+    if (A == 1)
+    {
+        *Inverse = 1;
+        return true;
+    }
+    uintn<Bits> Y;
+    if (!UIntModularInverseOdd(Modulus % A, A, &Y)) { return false; }
+
+    uintn<2 * Bits> Product = UIntMultiplyWide(Modulus, Y) - 1;
+    uintn<2 * Bits> WideA = 0;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { WideA.Parts[PartIndex] = A.Parts[PartIndex]; }
+    uintn<2 * Bits> K = Product / WideA; // Below Modulus since Y < A
+    *Inverse = Modulus - uintn<Bits>(K.Parts);
+    return true;
+}
 
-inline uint512
-operator<<(uint512 A, uint8_t Shift)
+// Floor of the square root of a single part, one result bit per step
+// (the schoolbook digit-by-digit method in base 2).
+inline uint64_t
+SquareRoot64(uint64_t N)
 {
-    uint512 Result;
-    assert(Shift <= 32); //TODO
-    for (int32_t PartIndex = UINT512_PARTS - 1;
-        PartIndex >= 0;
-        --PartIndex)
+    uint64_t Root = 0;
+    uint64_t Bit = (uint64_t)1 << 62;
+    while (Bit > N) { Bit >>= 2; }
+    for (; Bit != 0; Bit >>= 2)
     {
-        Result.Parts[PartIndex] = A.Parts[PartIndex] << Shift;
-        if (PartIndex != 0)
+        if (N >= Root + Bit)
+        {
+            N -= Root + Bit;
+            Root = (Root >> 1) + Bit;
+        }
+        else
         {
-            Result.Parts[PartIndex] |= A.Parts[PartIndex - 1] >> (32 - Shift);
+            Root >>= 1;
         }
     }
+    return Root;
+}
+
+// Floor of the square root of N, with N - Root^2 in *Remainder if given.
+// The seed is the exact root of the top 64 bits, rounded up, so Newton's
+// iteration starts above the answer and falls monotonically onto the floor.
+// The seed already has ~32 correct bits and each step doubles that, so 512
+// bits take four or five divisions.
+template <uint32_t Bits>
+inline uintn<Bits>
+UIntSquareRoot(uintn<Bits> N, uintn<Bits>* Remainder = 0)
+{
+    if (N == 0)
+    {
+        if (Remainder) { *Remainder = 0; }
+        return N;
+    }
+    uint32_t BitCount = SignificantBitCount(N);
+    uint32_t Shift = (BitCount > 64) ? ((BitCount - 64 + 1) & ~1u) : 0; // Even, so it halves exactly
+    uint64_t Top = (N >> Shift).Parts[0];
+    // sqrt(N) < sqrt(Top + 1) * 2^(Shift / 2) <= (SquareRoot64(Top) + 1) * 2^(Shift / 2)
+    uint64_t TopRoot = SquareRoot64(Top) + 1;
+    uintn<Bits> Root = uintn<Bits>(TopRoot) << (Shift / 2);
+
+    for (;;)
+    {
+        uintn<Bits> Next = (Root + N / Root) >> 1;
+        if (Next >= Root) { break; }
+        Root = Next;
+    }
+    if (Remainder) { *Remainder = N - Root * Root; }
+    return Root;
+}
+
+// Base^Exponent mod a Modulus below 2^32, for the residue filters below.
+inline uint64_t
+PowModSmall(uint64_t Base, uint64_t Exponent, uint64_t Modulus)
+{
+    uint64_t Result = 1;
+    Base %= Modulus;
+    for (; Exponent > 0; Exponent >>= 1)
+    {
+        if (Exponent & 1) { Result = Result * Base % Modulus; }
+        Base = Base * Base % Modulus;
+    }
     return Result;
 }
 
-inline uint512
-operator>>(uint512 A, uint8_t Shift)
+// True if N is a perfect square, with its root in *Root if given. Squares are
+// rare modulo small numbers, so nearly every non-square is rejected before any
+// wide arithmetic: first by the low 6 bits (12 of 64 residues are squares),
+// then by Euler's criterion modulo the prime factors of 2^64 - 1, using one
+// residue mod 2^64 - 1 that is just the parts summed with end-around carry.
+// Together the filters pass about 1 non-square in 400.
+template <uint32_t Bits>
+inline bool
+UIntIsPerfectSquare(uintn<Bits> N, uintn<Bits>* Root = 0)
 {
-    assert(Shift <= 32); //TODO
-    uint512 Result;
-    for (int32_t PartIndex = 0;
-        PartIndex < UINT512_PARTS;
-        ++PartIndex)
+    const uint64_t SquaresMod64 = 0x0202021202030213; // Bit R set iff R is a square mod 64
+    if (((SquaresMod64 >> (N.Parts[0] & 63)) & 1) == 0) { return false; }
+
+    uint64_t Residue = 0;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        uint8_t Carry = AddWithCarry(0, Residue, N.Parts[PartIndex], &Residue);
+        Residue += Carry;
+    }
+    const uint64_t Primes[] = { 3, 5, 17, 257, 641, 65537, 6700417 }; // 2^64 - 1
+    for (int32_t PrimeIndex = 0; PrimeIndex < (int32_t)(sizeof(Primes) / sizeof(Primes[0])); ++PrimeIndex)
+    {
+        uint64_t Prime = Primes[PrimeIndex];
+        uint64_t R = Residue % Prime;
+        if (R != 0 && PowModSmall(R, (Prime - 1) / 2, Prime) != 1) { return false; }
+    }
+
+    uintn<Bits> Remainder;
+    uintn<Bits> SquareRoot = UIntSquareRoot(N, &Remainder);
+    if (Root) { *Root = SquareRoot; }
+    return Remainder == 0;
+}
+
+// Montgomery arithmetic modulo a fixed odd Modulus. Values are kept in
+// Montgomery form (A * R mod Modulus with R = 2^Bits), in which a modular
+// product needs only multiplications and a word-by-word reduction, no division.
+// Every value passed in must already be reduced below Modulus.
+template <uint32_t Bits>
+struct montgomery_context
+{
+    uintn<Bits> Modulus;
+    uintn<Bits> One;       // R mod Modulus, i.e. 1 in Montgomery form
+    uintn<Bits> RSquared;  // R^2 mod Modulus, used to convert into Montgomery form
+    uint64_t NPrime;       // -Modulus^-1 mod 2^64; word-by-word reduction only needs the low limb of n'
+};
+
+typedef montgomery_context<512> montgomery512;
+
+// Montgomery reduction (REDC) of the 2 * PartCount limb number in T, which must
+// be below Modulus * R. Returns T * R^-1 mod Modulus. T is clobbered.
+template <uint32_t Bits>
+constexpr uintn<Bits>
+MontgomeryReduce(const montgomery_context<Bits>* Context, uint64_t* T)
+{
+    const int32_t Count = uintn<Bits>::PartCount;
+    BIGINT_COUNT_LOOP(BigintLoop_LimbProducts, Count * Count);
+    // Carry out of the top of the window, folded into the next row instead of
+    // being propagated through the remaining limbs.
+    uint8_t Overflow = 0;
+    UINTN_UNROLL
+    for (int32_t I = 0; I < Count; ++I)
     {
-        Result.Parts[PartIndex] = A.Parts[PartIndex] >> Shift;
-        if (PartIndex != UINT512_PARTS)
+        // Adding M * Modulus zeroes limb I, so the value shifts down a limb each round.
+        uint64_t M = T[I] * Context->NPrime;
+        uint64_t Carry = 0;
+        UINTN_UNROLL
+        for (int32_t J = 0; J < Count; ++J)
         {
-            Result.Parts[PartIndex] |= A.Parts[PartIndex + 1] << (32 - Shift);
+            T[I + J] = MultiplyAddWithCarry(M, Context->Modulus.Parts[J], T[I + J], &Carry);
         }
+        Overflow = AddWithCarry(Overflow, T[I + Count], Carry, &T[I + Count]);
+    }
+
+    // The result is below 2 * Modulus: one conditional subtraction finishes it.
+    uintn<Bits> Result(T + Count);
+    if (Overflow || Result >= Context->Modulus)
+    {
+        UIntSubtract(&Result, Result, Context->Modulus);
     }
     return Result;
 }
 
-inline uint512
-operator*(uint512 A, uint512 B)
+template <uint32_t Bits>
+constexpr uintn<Bits>
+MontgomeryMultiply(const montgomery_context<Bits>* Context, const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    BIGINT_COUNT_OP(BigintOp_MontgomeryMultiply, A, B);
+    const int32_t Count = uintn<Bits>::PartCount;
+    uint64_t T[2 * Count] = {};
+    limb_multiply<Count>::Wide(T, A.Parts, B.Parts);
+    return MontgomeryReduce(Context, T);
+}
+
+template <uint32_t Bits>
+constexpr uintn<Bits>
+MontgomerySquare(const montgomery_context<Bits>* Context, const uintn<Bits>& A)
 {
-    uint512 Result = 0;
-    while (A >= 1)
+    BIGINT_COUNT_UNARY(BigintOp_MontgomerySquare, A);
+    const int32_t Count = uintn<Bits>::PartCount;
+    uint64_t T[2 * Count] = {};
+    limb_multiply<Count>::Square(T, A.Parts);
+    return MontgomeryReduce(Context, T);
+}
+
+// Addition and subtraction are the same in and out of Montgomery form.
+template <uint32_t Bits>
+constexpr uintn<Bits>
+MontgomeryAdd(const montgomery_context<Bits>* Context, const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    uintn<Bits> Result;
+    uint8_t Carry = UIntAdd(&Result, A, B);
+    if (Carry || Result >= Context->Modulus)
     {
-        if ((A.Parts[0] & 1) == 1) Result = Result + B;
-        A = A >> 1;
-        B = B << 1;
+        UIntSubtract(&Result, Result, Context->Modulus);
     }
     return Result;
 }
 
-inline uint512
-operator-(uint512 A)
+template <uint32_t Bits>
+constexpr uintn<Bits>
+MontgomerySubtract(const montgomery_context<Bits>* Context, const uintn<Bits>& A, const uintn<Bits>& B)
 {
-    uint512 Result;
-    for (int PartIndex = 0;
-        PartIndex < UINT512_PARTS;
-        ++PartIndex)
+    uintn<Bits> Result;
+    if (UIntSubtract(&Result, A, B))
     {
-        Result.Parts[PartIndex] = ~A.Parts[PartIndex];
+        UIntAdd(&Result, Result, Context->Modulus);
     }
-    return Result + 1;
+    return Result;
 }
 
-inline uint512
-operator-(uint512 Left, uint512 Right)
+template <uint32_t Bits>
+constexpr void
+MontgomeryInit(montgomery_context<Bits>* Context, uintn<Bits> Modulus)
 {
-    return Left + -Right;
+    assert((Modulus.Parts[0] & 1) == 1);
+    Context->Modulus = Modulus;
+
+    // Newton's iteration for the inverse mod 2^64: each step doubles the number
+    // of correct low bits, and any odd N is its own inverse mod 2^3.
+    uint64_t Inverse = Modulus.Parts[0];
+    for (int Step = 0; Step < 5; ++Step) { Inverse *= 2 - Modulus.Parts[0] * Inverse; }
+    Context->NPrime = 0 - Inverse;
+
+    // R mod N == (R - N) mod N, and R - N is just -N in Bits-bit arithmetic.
+    Context->One = (uintn<Bits>(0) - Modulus) % Modulus;
+    // R^2 mod N by doubling R mod N another Bits times. Setup only, so a
+    // modular add per bit is cheaper than building a 2 * Bits division.
+    uintn<Bits> RSquared = Context->One;
+    for (uint32_t Bit = 0; Bit < Bits; ++Bit) { RSquared = MontgomeryAdd(Context, RSquared, RSquared); }
+    Context->RSquared = RSquared;
 }
 
-inline bool
-GetBitAt(uint512 A, uint32_t Place)
+// The context as a value, so a fixed modulus can have its whole context computed
+// at compile time:
+//   static constexpr montgomery_context<256> P256 = MakeMontgomeryContext(0xFFFF..._u256);
+template <uint32_t Bits>
+constexpr montgomery_context<Bits>
+MakeMontgomeryContext(const uintn<Bits>& Modulus)
 {
-    assert(Place < 512); // Zero-indexed
-    int Part = Place / 32;
-    int PartPlace = Place - Part;
-    return (A.Parts[Part] >> PartPlace) & 1;
+    montgomery_context<Bits> Result = {};
+    MontgomeryInit(&Result, Modulus);
+    return Result;
 }
 
-inline void
-SetBitAt(uint512* A, uint32_t Place, bool Value)
+// Conversions happen outside the hot loops, so ToMontgomery accepts any A and
+// reduces it first if needed.
+template <uint32_t Bits>
+constexpr uintn<Bits>
+ToMontgomery(const montgomery_context<Bits>* Context, uintn<Bits> A)
 {
-    assert(Place < 512); // Zero-indexed
-    int Part = Place / 32;
-    int PartPlace = Place - Part;
-    int BitValue = (A->Parts[Part] >> PartPlace) & 1;
-    if (Value) { BitValue = !BitValue; }
-    // If XOR'd with itself, will be zero (false)
-    // If XOR'd with its negation, will be one (true)
-    A->Parts[Part] ^= BitValue << PartPlace;
+    if (A >= Context->Modulus) { A %= Context->Modulus; }
+    return MontgomeryMultiply(Context, A, Context->RSquared);
 }
 
-struct uint512_divison_result
+template <uint32_t Bits>
+constexpr uintn<Bits>
+FromMontgomery(const montgomery_context<Bits>* Context, uintn<Bits> A)
 {
-    uint512 Quotient;
-    uint512 Remainder;
-};
+    const int32_t Count = uintn<Bits>::PartCount;
+    uint64_t T[2 * Count] = {};
+    for (int32_t PartIndex = 0; PartIndex < Count; ++PartIndex)
+    {
+        T[PartIndex] = A.Parts[PartIndex];
+        T[Count + PartIndex] = 0;
+    }
+    return MontgomeryReduce(Context, T);
+}
 
-// Egyptian division algorithm for computing A / B
-inline uint512_divison_result
-UInt512Division(uint512 A, uint512 B)
+// Inverts Count values in Montgomery form at once (Montgomery's trick): prefix
+// products on the way up, one real inversion of the total, and the individual
+// inverses peeled off on the way down, 3 * (Count - 1) multiplications in all.
+// Inverses (also Montgomery form) must not alias Values. Returns false if any
+// value shares a factor with the modulus; Inverses then holds scratch.
+template <uint32_t Bits>
+inline bool
+MontgomeryBatchInverse(const montgomery_context<Bits>* Context, const uintn<Bits>* Values,
+                       uintn<Bits>* Inverses, uint32_t Count)
 {
-    assert(B != 0);
-    if (A < B) { 
-        uint512_divison_result Result = { 0, A };
-        return Result;
+    if (Count == 0) { return true; }
+    uintn<Bits>* Prefix = Inverses; // Prefix[I] = Values[0] * ... * Values[I]
+    uintn<Bits> Running = Values[0];
+    for (uint32_t Index = 1; Index < Count; ++Index)
+    {
+        Prefix[Index - 1] = Running;
+        Running = MontgomeryMultiply(Context, Running, Values[Index]);
+    }
+
+    // (P * R)^-1 * R == (P^-1 mod N) in Montgomery form.
+    uintn<Bits> TotalInverse;
+    if (!UIntModularInverse(FromMontgomery(Context, Running), Context->Modulus, &TotalInverse)) { return false; }
+    Running = ToMontgomery(Context, TotalInverse);
+
+    for (uint32_t Index = Count - 1; Index > 0; --Index)
+    {
+        uintn<Bits> Value = Values[Index];
+        Inverses[Index] = MontgomeryMultiply(Context, Running, Prefix[Index - 1]);
+        Running = MontgomeryMultiply(Context, Running, Value);
     }
+    Inverses[0] = Running;
+    return true;
+}
+
+// Left-to-right sliding-window exponentiation of a value in Montgomery form.
+// The exponent is scanned for windows of up to WindowBits bits that start and end
+// on a set bit, so each window costs its squarings plus one multiplication by a
+// precomputed odd power Base^1, Base^3, ..., Base^(2^WindowBits - 1).
+template <uint32_t Bits>
+inline uintn<Bits>
+MontgomeryPower(const montgomery_context<Bits>* Context, uintn<Bits> Base, uintn<Bits> Exponent)
+{
+    uint32_t ExponentBits = SignificantBitCount(Exponent);
+    if (ExponentBits == 0) { return Context->One; }
 
-    uint512 C = B;
-    while (A - C >= C) C = C + C; // Largest doubling of B
-    uint512 N = 1;
-    A = A - C;
+    // Wider windows save multiplications but cost 2^(WindowBits-1) table entries up front.
+    uint32_t WindowBits = (ExponentBits <= 32) ? 2 :
+                          (ExponentBits <= 128) ? 3 :
+                          (ExponentBits <= 384) ? 4 :
+                          (ExponentBits <= 1024) ? 5 : 6;
+    uintn<Bits> OddPowers[32];
+    OddPowers[0] = Base;
+    uintn<Bits> BaseSquared = MontgomerySquare(Context, Base);
+    for (uint32_t Index = 1; Index < (1u << (WindowBits - 1)); ++Index)
+    {
+        OddPowers[Index] = MontgomeryMultiply(Context, OddPowers[Index - 1], BaseSquared);
+    }
 
-    while (C != B)
+    uintn<Bits> Result = Context->One;
+    bool ResultIsOne = true;
+    int32_t Bit = (int32_t)ExponentBits - 1;
+    while (Bit >= 0)
     {
-        C = C >> 1; // Half(C);
-		N = N + N;
-        if (C <= A) { A = A - C; N = N + 1; }
+        if (!GetBitAt(Exponent, Bit))
+        {
+            Result = MontgomerySquare(Context, Result);
+            --Bit;
+            continue;
+        }
+
+        // Longest window [Low, Bit] no wider than WindowBits that ends on a set bit.
+        int32_t Low = Bit - (int32_t)WindowBits + 1;
+        if (Low < 0) { Low = 0; }
+        while (!GetBitAt(Exponent, Low)) { ++Low; }
+
+        uint32_t Window = 0;
+        for (int32_t WindowBit = Bit; WindowBit >= Low; --WindowBit)
+        {
+            Window = (Window << 1) | (GetBitAt(Exponent, WindowBit) ? 1 : 0);
+        }
+
+        if (ResultIsOne)
+        {
+            Result = OddPowers[Window >> 1];
+            ResultIsOne = false;
+        }
+        else
+        {
+            for (int32_t Square = Low; Square <= Bit; ++Square) { Result = MontgomerySquare(Context, Result); }
+            Result = MontgomeryMultiply(Context, Result, OddPowers[Window >> 1]);
+        }
+        Bit = Low - 1;
     }
+    return Result;
+}
 
-    uint512_divison_result Result = { N, A };
+// 2^Exponent in Montgomery form. Multiplying by the base is just a doubling here,
+// so plain left-to-right square-and-double beats any window: one modular
+// shift-and-subtract per set bit instead of a multiplication.
+template <uint32_t Bits>
+inline uintn<Bits>
+MontgomeryPowerOfTwo(const montgomery_context<Bits>* Context, uintn<Bits> Exponent)
+{
+    uintn<Bits> Result = Context->One;
+    for (int32_t Bit = (int32_t)SignificantBitCount(Exponent) - 1; Bit >= 0; --Bit)
+    {
+        Result = MontgomerySquare(Context, Result);
+        if (GetBitAt(Exponent, Bit)) { Result = MontgomeryAdd(Context, Result, Result); }
+    }
     return Result;
 }
 
-inline uint512
-operator/(uint512 N, uint512 D)
+// Base^Exponent mod Modulus for ordinary (non-Montgomery) values, reusing a context.
+template <uint32_t Bits>
+inline uintn<Bits>
+PowMod(const montgomery_context<Bits>* Context, uintn<Bits> Base, uintn<Bits> Exponent)
 {
-    uint512_divison_result Result = UInt512Division(N, D);
-    return Result.Quotient;
+    uintn<Bits> Result;
+    if (Base == 2 && Context->Modulus > 2)
+    {
+        Result = MontgomeryPowerOfTwo(Context, Exponent);
+    }
+    else
+    {
+        Result = MontgomeryPower(Context, ToMontgomery(Context, Base), Exponent);
+    }
+    return FromMontgomery(Context, Result);
 }
 
-inline uint512
-operator%(uint512 N, uint512 D)
+// Base^Exponent mod Modulus. Modulus must be odd.
+template <uint32_t Bits>
+inline uintn<Bits>
+PowMod(uintn<Bits> Base, uintn<Bits> Exponent, uintn<Bits> Modulus)
 {
-    uint512_divison_result Result = UInt512Division(N, D);
-    return Result.Remainder;
+    montgomery_context<Bits> Context;
+    MontgomeryInit(&Context, Modulus);
+    return PowMod(&Context, Base, Exponent);
 }
 
 #define BIGINT_CPP
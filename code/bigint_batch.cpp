@@ -0,0 +1,730 @@
+#if !defined(BIGINT_BATCH_CPP)
+#include <stdlib.h>
+#include "bigint.cpp"
+
+// BATCH ARITHMETIC:
+// uintn_batch keeps many numbers structure-of-arrays: part P of every value sits
+// in one contiguous row, Parts[P * Stride + Index]. A vector load then picks up
+// the same part of 4 (AVX2) or 8 (AVX-512) different values. Carries and borrows
+// run lane-wise down the rows, so one pass over the parts adds, subtracts or
+// compares a whole vector of values. The cost scales with Count / lanes instead
+// of with Count.
+//
+// Stride is Count rounded up to BATCH_BLOCK lanes, and rows are 64-byte
+// aligned, so the kernels only ever see whole aligned blocks. Padding lanes stay
+// zero.
+//
+// The kernels are picked at first use from what the CPU reports: AVX-512F,
+// then AVX2, then a portable scalar loop. GCC and clang compile the vector
+// kernels with target attributes, so the file needs no -mavx flags and still
+// runs on machines without them. BatchUseKernels forces a set (for
+// benchmarking, or for checking one against another).
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATCH_X64 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define BATCH_TARGET(Target) __attribute__((target(Target)))
+#else
+#define BATCH_TARGET(Target)
+#endif
+#endif
+
+#define BATCH_BLOCK 8 // Lanes per kernel step: one AVX-512 vector, two AVX2 vectors
+
+// Largest divisor UIntBatchRemainderByPart handles in vector registers; larger
+// ones take the scalar path.
+#define BATCH_SMALL_DIVISOR_MAX 65536
+
+template <uint32_t Bits>
+struct uintn_batch
+{
+    static const int32_t PartCount = Bits / 64;
+
+    uint64_t* Parts;  // Parts[PartIndex * Stride + Index]
+    uint32_t Count;
+    uint32_t Stride;
+};
+
+typedef uintn_batch<256> uint256_batch;
+typedef uintn_batch<512> uint512_batch;
+
+// A small divisor prepared once per UIntBatchRemainderByPart call. The vector
+// kernels split each part into two 32-bit digits, multiply each digit by its
+// weight 2^(32 * Digit) mod Divisor and reduce the running sum with a
+// double-precision reciprocal every 16 digits. With Divisor <= 2^16 the sum
+// stays below 2^52, where doubles are exact.
+struct batch_divisor
+{
+    uint64_t Divisor;
+    part_divisor Preinverted;   // scalar path
+    double Inverse;             // 1.0 / Divisor
+    const uint64_t* Weights;    // one per 32-bit digit, lowest first
+};
+
+struct batch_kernels
+{
+    const char* Name;
+    void (*Add)(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride);
+    void (*Subtract)(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride);
+    void (*Less)(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride);
+    void (*Equal)(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride);
+    // Lanes [Begin, End), whole blocks; writes Remainders[Index - Begin].
+    void (*RemainderByPart)(uint64_t* Remainders, const uint64_t* A, int32_t PartCount, uint32_t Stride,
+                            uint32_t Begin, uint32_t End, const batch_divisor* Divisor);
+};
+
+enum batch_isa
+{
+    BatchISA_Scalar,
+    BatchISA_AVX2,
+    BatchISA_AVX512,
+};
+
+//
+// Scalar kernels. Same block order as the vector ones: parts outer, the
+// BATCH_BLOCK lanes of a block inner, carries kept per lane.
+//
+
+static void
+BatchAddScalar(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        uint8_t Carry[BATCH_BLOCK] = {};
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index)
+            {
+                Carry[Index] = AddWithCarry(Carry[Index], A[Row + Index], B[Row + Index], &Result[Row + Index]);
+            }
+        }
+    }
+}
+
+static void
+BatchSubtractScalar(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        uint8_t Borrow[BATCH_BLOCK] = {};
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index)
+            {
+                Borrow[Index] = SubtractWithBorrow(Borrow[Index], A[Row + Index], B[Row + Index], &Result[Row + Index]);
+            }
+        }
+    }
+}
+
+// A < B is the borrow out of A - B; the difference itself is dropped.
+static void
+BatchLessScalar(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        uint8_t Borrow[BATCH_BLOCK] = {};
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index)
+            {
+                uint64_t Unused;
+                Borrow[Index] = SubtractWithBorrow(Borrow[Index], A[Row + Index], B[Row + Index], &Unused);
+            }
+        }
+        uint8_t Mask = 0;
+        for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index) { Mask |= (uint8_t)(Borrow[Index] << Index); }
+        Masks[Lane / BATCH_BLOCK] = Mask;
+    }
+}
+
+static void
+BatchEqualScalar(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        uint64_t Difference[BATCH_BLOCK] = {};
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index) { Difference[Index] |= A[Row + Index] ^ B[Row + Index]; }
+        }
+        uint8_t Mask = 0;
+        for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index) { Mask |= (uint8_t)((Difference[Index] == 0) << Index); }
+        Masks[Lane / BATCH_BLOCK] = Mask;
+    }
+}
+
+// Any divisor: the UIntRemainderByPart loop, walking one lane down its column.
+static void
+BatchRemainderByPartColumns(uint64_t* Remainders, const uint64_t* A, int32_t PartCount, uint32_t Stride,
+                            uint32_t Begin, uint32_t End, const batch_divisor* Divisor)
+{
+    const part_divisor* Preinverted = &Divisor->Preinverted;
+    uint32_t Shift = Preinverted->Shift;
+    for (uint32_t Lane = Begin; Lane < End; ++Lane)
+    {
+        const uint64_t* Column = A + Lane;
+        uint64_t Remainder = (Shift == 0) ? 0 : Column[(size_t)(PartCount - 1) * Stride] >> (64 - Shift);
+        for (int32_t PartIndex = PartCount - 1; PartIndex >= 0; --PartIndex)
+        {
+            uint64_t Part = Column[(size_t)PartIndex * Stride] << Shift;
+            if (Shift != 0 && PartIndex > 0) { Part |= Column[(size_t)(PartIndex - 1) * Stride] >> (64 - Shift); }
+            Remainder = RemainderWidePreinverted(Remainder, Part, Preinverted);
+        }
+        Remainders[Lane - Begin] = Remainder >> Shift;
+    }
+}
+
+// Small divisors take the weighted digit sums of the vector kernels, with one
+// hardware divide per 16 digits instead of a preinverted step per part.
+static void
+BatchRemainderByPartScalar(uint64_t* Remainders, const uint64_t* A, int32_t PartCount, uint32_t Stride,
+                           uint32_t Begin, uint32_t End, const batch_divisor* Divisor)
+{
+    if (Divisor->Divisor > BATCH_SMALL_DIVISOR_MAX)
+    {
+        BatchRemainderByPartColumns(Remainders, A, PartCount, Stride, Begin, End, Divisor);
+        return;
+    }
+    for (uint32_t Lane = Begin; Lane < End; Lane += BATCH_BLOCK)
+    {
+        uint64_t Sum[BATCH_BLOCK] = {};
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            const uint64_t* Row = A + (size_t)PartIndex * Stride + Lane;
+            uint64_t LowWeight = Divisor->Weights[2 * PartIndex];
+            uint64_t HighWeight = Divisor->Weights[2 * PartIndex + 1];
+            for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index)
+            {
+                Sum[Index] += (Row[Index] & 0xFFFFFFFF) * LowWeight + (Row[Index] >> 32) * HighWeight;
+            }
+            if ((PartIndex & 7) == 7 || PartIndex == PartCount - 1)
+            {
+                for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index) { Sum[Index] %= Divisor->Divisor; }
+            }
+        }
+        for (int32_t Index = 0; Index < BATCH_BLOCK; ++Index) { Remainders[Lane - Begin + Index] = Sum[Index]; }
+    }
+}
+
+static const batch_kernels BatchKernelsScalar =
+{
+    "scalar", BatchAddScalar, BatchSubtractScalar, BatchLessScalar, BatchEqualScalar, BatchRemainderByPartScalar,
+};
+
+#if defined(BATCH_X64)
+
+//
+// AVX2 kernels, 4 lanes per vector. AVX2 has no unsigned 64-bit compare, so the
+// carry out of A + B + CarryIn is taken from the top bits instead:
+// (A & B) | ((A | B) & ~Sum), and the borrow out of A - B - BorrowIn from
+// (~A & B) | (~(A ^ B) & Difference).
+//
+
+BATCH_TARGET("avx2") static void
+BatchAddAVX2(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += 4)
+    {
+        __m256i Carry = _mm256_setzero_si256();
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            __m256i X = _mm256_load_si256((const __m256i*)(A + Row));
+            __m256i Y = _mm256_load_si256((const __m256i*)(B + Row));
+            __m256i Sum = _mm256_add_epi64(_mm256_add_epi64(X, Y), Carry);
+            Carry = _mm256_srli_epi64(_mm256_or_si256(_mm256_and_si256(X, Y),
+                                                      _mm256_andnot_si256(Sum, _mm256_or_si256(X, Y))), 63);
+            _mm256_store_si256((__m256i*)(Result + Row), Sum);
+        }
+    }
+}
+
+BATCH_TARGET("avx2") static void
+BatchSubtractAVX2(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += 4)
+    {
+        __m256i Borrow = _mm256_setzero_si256();
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            __m256i X = _mm256_load_si256((const __m256i*)(A + Row));
+            __m256i Y = _mm256_load_si256((const __m256i*)(B + Row));
+            __m256i Difference = _mm256_sub_epi64(_mm256_sub_epi64(X, Y), Borrow);
+            Borrow = _mm256_srli_epi64(_mm256_or_si256(_mm256_andnot_si256(X, Y),
+                                                       _mm256_andnot_si256(_mm256_xor_si256(X, Y), Difference)), 63);
+            _mm256_store_si256((__m256i*)(Result + Row), Difference);
+        }
+    }
+}
+
+BATCH_TARGET("avx2") static void
+BatchLessAVX2(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        __m256i BorrowLow = _mm256_setzero_si256();
+        __m256i BorrowHigh = _mm256_setzero_si256();
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            __m256i X = _mm256_load_si256((const __m256i*)(A + Row));
+            __m256i Y = _mm256_load_si256((const __m256i*)(B + Row));
+            __m256i Difference = _mm256_sub_epi64(_mm256_sub_epi64(X, Y), BorrowLow);
+            BorrowLow = _mm256_srli_epi64(_mm256_or_si256(_mm256_andnot_si256(X, Y),
+                                                          _mm256_andnot_si256(_mm256_xor_si256(X, Y), Difference)), 63);
+            X = _mm256_load_si256((const __m256i*)(A + Row + 4));
+            Y = _mm256_load_si256((const __m256i*)(B + Row + 4));
+            Difference = _mm256_sub_epi64(_mm256_sub_epi64(X, Y), BorrowHigh);
+            BorrowHigh = _mm256_srli_epi64(_mm256_or_si256(_mm256_andnot_si256(X, Y),
+                                                           _mm256_andnot_si256(_mm256_xor_si256(X, Y), Difference)), 63);
+        }
+        int Low = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_slli_epi64(BorrowLow, 63)));
+        int High = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_slli_epi64(BorrowHigh, 63)));
+        Masks[Lane / BATCH_BLOCK] = (uint8_t)(Low | (High << 4));
+    }
+}
+
+BATCH_TARGET("avx2") static void
+BatchEqualAVX2(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        __m256i DifferenceLow = _mm256_setzero_si256();
+        __m256i DifferenceHigh = _mm256_setzero_si256();
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            DifferenceLow = _mm256_or_si256(DifferenceLow, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(A + Row)),
+                                                                            _mm256_load_si256((const __m256i*)(B + Row))));
+            DifferenceHigh = _mm256_or_si256(DifferenceHigh, _mm256_xor_si256(_mm256_load_si256((const __m256i*)(A + Row + 4)),
+                                                                              _mm256_load_si256((const __m256i*)(B + Row + 4))));
+        }
+        __m256i Zero = _mm256_setzero_si256();
+        int Low = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(DifferenceLow, Zero)));
+        int High = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(DifferenceHigh, Zero)));
+        Masks[Lane / BATCH_BLOCK] = (uint8_t)(Low | (High << 4));
+    }
+}
+
+// Sum mod Divisor for Sum < 2^52. Integers below 2^52 convert to and from
+// doubles exactly by OR-ing in (and subtracting) the bit pattern of 2^52. The
+// quotient estimate is off by at most one, fixed up on the remainder.
+BATCH_TARGET("avx2") static inline __m256i
+BatchReduceAVX2(__m256i Sum, __m256d Divisor, __m256d Inverse)
+{
+    const __m256i MagicBits = _mm256_set1_epi64x(0x4330000000000000);
+    const __m256d Magic = _mm256_set1_pd(4503599627370496.0);
+    __m256d Value = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(Sum, MagicBits)), Magic);
+    __m256d Quotient = _mm256_floor_pd(_mm256_mul_pd(Value, Inverse));
+    __m256d Remainder = _mm256_sub_pd(Value, _mm256_mul_pd(Quotient, Divisor));
+    Remainder = _mm256_add_pd(Remainder, _mm256_and_pd(_mm256_cmp_pd(Remainder, _mm256_setzero_pd(), _CMP_LT_OQ), Divisor));
+    Remainder = _mm256_sub_pd(Remainder, _mm256_and_pd(_mm256_cmp_pd(Remainder, Divisor, _CMP_GE_OQ), Divisor));
+    return _mm256_xor_si256(_mm256_castpd_si256(_mm256_add_pd(Remainder, Magic)), MagicBits);
+}
+
+BATCH_TARGET("avx2") static void
+BatchRemainderByPartAVX2(uint64_t* Remainders, const uint64_t* A, int32_t PartCount, uint32_t Stride,
+                         uint32_t Begin, uint32_t End, const batch_divisor* Divisor)
+{
+    if (Divisor->Divisor > BATCH_SMALL_DIVISOR_MAX)
+    {
+        BatchRemainderByPartColumns(Remainders, A, PartCount, Stride, Begin, End, Divisor);
+        return;
+    }
+    __m256d DivisorValue = _mm256_set1_pd((double)Divisor->Divisor);
+    __m256d Inverse = _mm256_set1_pd(Divisor->Inverse);
+    for (uint32_t Lane = Begin; Lane < End; Lane += 4)
+    {
+        __m256i Sum = _mm256_setzero_si256();
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            __m256i X = _mm256_load_si256((const __m256i*)(A + (size_t)PartIndex * Stride + Lane));
+            __m256i Low = _mm256_mul_epu32(X, _mm256_set1_epi64x((int64_t)Divisor->Weights[2 * PartIndex]));
+            __m256i High = _mm256_mul_epu32(_mm256_srli_epi64(X, 32), _mm256_set1_epi64x((int64_t)Divisor->Weights[2 * PartIndex + 1]));
+            Sum = _mm256_add_epi64(Sum, _mm256_add_epi64(Low, High));
+            if ((PartIndex & 7) == 7 || PartIndex == PartCount - 1) { Sum = BatchReduceAVX2(Sum, DivisorValue, Inverse); }
+        }
+        _mm256_storeu_si256((__m256i*)(Remainders + (Lane - Begin)), Sum);
+    }
+}
+
+static const batch_kernels BatchKernelsAVX2 =
+{
+    "avx2", BatchAddAVX2, BatchSubtractAVX2, BatchLessAVX2, BatchEqualAVX2, BatchRemainderByPartAVX2,
+};
+
+//
+// AVX-512F kernels, 8 lanes per vector. Unsigned compares produce mask
+// registers directly, so carries, borrows and results all live in masks.
+//
+
+BATCH_TARGET("avx512f") static void
+BatchAddAVX512(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    const __m512i One = _mm512_set1_epi64(1);
+    const __m512i AllOnes = _mm512_set1_epi64(-1);
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        __mmask8 Carry = 0;
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            __m512i X = _mm512_load_si512((const void*)(A + Row));
+            __m512i Sum = _mm512_add_epi64(X, _mm512_load_si512((const void*)(B + Row)));
+            // Out if X + Y wrapped, or the carry in lands on an all-ones sum.
+            __mmask8 CarryOut = _mm512_cmplt_epu64_mask(Sum, X) | _mm512_mask_cmpeq_epu64_mask(Carry, Sum, AllOnes);
+            Sum = _mm512_mask_add_epi64(Sum, Carry, Sum, One);
+            Carry = CarryOut;
+            _mm512_store_si512((void*)(Result + Row), Sum);
+        }
+    }
+}
+
+BATCH_TARGET("avx512f") static void
+BatchSubtractAVX512(uint64_t* Result, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    const __m512i One = _mm512_set1_epi64(1);
+    const __m512i Zero = _mm512_setzero_si512();
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        __mmask8 Borrow = 0;
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            __m512i X = _mm512_load_si512((const void*)(A + Row));
+            __m512i Y = _mm512_load_si512((const void*)(B + Row));
+            __m512i Difference = _mm512_sub_epi64(X, Y);
+            __mmask8 BorrowOut = _mm512_cmplt_epu64_mask(X, Y) | _mm512_mask_cmpeq_epu64_mask(Borrow, Difference, Zero);
+            Difference = _mm512_mask_sub_epi64(Difference, Borrow, Difference, One);
+            Borrow = BorrowOut;
+            _mm512_store_si512((void*)(Result + Row), Difference);
+        }
+    }
+}
+
+BATCH_TARGET("avx512f") static void
+BatchLessAVX512(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        // Lowest part first: a higher part decides unless it is equal, in
+        // which case the verdict from below stands.
+        __mmask8 Less = 0;
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            __m512i X = _mm512_load_si512((const void*)(A + Row));
+            __m512i Y = _mm512_load_si512((const void*)(B + Row));
+            Less = _mm512_cmplt_epu64_mask(X, Y) | _mm512_mask_cmpeq_epu64_mask(Less, X, Y);
+        }
+        Masks[Lane / BATCH_BLOCK] = (uint8_t)Less;
+    }
+}
+
+BATCH_TARGET("avx512f") static void
+BatchEqualAVX512(uint8_t* Masks, const uint64_t* A, const uint64_t* B, int32_t PartCount, uint32_t Stride)
+{
+    for (uint32_t Lane = 0; Lane < Stride; Lane += BATCH_BLOCK)
+    {
+        __mmask8 Equal = 0xFF;
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            size_t Row = (size_t)PartIndex * Stride + Lane;
+            Equal = _mm512_mask_cmpeq_epu64_mask(Equal, _mm512_load_si512((const void*)(A + Row)),
+                                                 _mm512_load_si512((const void*)(B + Row)));
+        }
+        Masks[Lane / BATCH_BLOCK] = (uint8_t)Equal;
+    }
+}
+
+// BatchReduceAVX2 at twice the width. The unmasked forms of roundscale, srli and
+// mul_epu32 pass _mm512_undefined_* as their merge source, which GCC reports as
+// maybe-uninitialized; the all-lanes maskz forms are the same instructions.
+#define BATCH_ALL_LANES ((__mmask8)0xFF)
+
+BATCH_TARGET("avx512f") static inline __m512i
+BatchReduceAVX512(__m512i Sum, __m512d Divisor, __m512d Inverse)
+{
+    const __m512i MagicBits = _mm512_set1_epi64(0x4330000000000000);
+    const __m512d Magic = _mm512_set1_pd(4503599627370496.0);
+    __m512d Value = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(Sum, MagicBits)), Magic);
+    __m512d Quotient = _mm512_maskz_roundscale_pd(BATCH_ALL_LANES, _mm512_mul_pd(Value, Inverse),
+                                                    _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512d Remainder = _mm512_sub_pd(Value, _mm512_mul_pd(Quotient, Divisor));
+    Remainder = _mm512_mask_add_pd(Remainder, _mm512_cmp_pd_mask(Remainder, _mm512_setzero_pd(), _CMP_LT_OQ), Remainder, Divisor);
+    Remainder = _mm512_mask_sub_pd(Remainder, _mm512_cmp_pd_mask(Remainder, Divisor, _CMP_GE_OQ), Remainder, Divisor);
+    return _mm512_xor_si512(_mm512_castpd_si512(_mm512_add_pd(Remainder, Magic)), MagicBits);
+}
+
+BATCH_TARGET("avx512f") static void
+BatchRemainderByPartAVX512(uint64_t* Remainders, const uint64_t* A, int32_t PartCount, uint32_t Stride,
+                           uint32_t Begin, uint32_t End, const batch_divisor* Divisor)
+{
+    if (Divisor->Divisor > BATCH_SMALL_DIVISOR_MAX)
+    {
+        BatchRemainderByPartColumns(Remainders, A, PartCount, Stride, Begin, End, Divisor);
+        return;
+    }
+    __m512d DivisorValue = _mm512_set1_pd((double)Divisor->Divisor);
+    __m512d Inverse = _mm512_set1_pd(Divisor->Inverse);
+    for (uint32_t Lane = Begin; Lane < End; Lane += BATCH_BLOCK)
+    {
+        __m512i Sum = _mm512_setzero_si512();
+        for (int32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+        {
+            __m512i X = _mm512_load_si512((const void*)(A + (size_t)PartIndex * Stride + Lane));
+            __m512i LowWeight = _mm512_set1_epi64((int64_t)Divisor->Weights[2 * PartIndex]);
+            __m512i HighWeight = _mm512_set1_epi64((int64_t)Divisor->Weights[2 * PartIndex + 1]);
+            __m512i Low = _mm512_maskz_mul_epu32(BATCH_ALL_LANES, X, LowWeight);
+            __m512i High = _mm512_maskz_mul_epu32(BATCH_ALL_LANES, _mm512_maskz_srli_epi64(BATCH_ALL_LANES, X, 32), HighWeight);
+            Sum = _mm512_add_epi64(Sum, _mm512_add_epi64(Low, High));
+            if ((PartIndex & 7) == 7 || PartIndex == PartCount - 1) { Sum = BatchReduceAVX512(Sum, DivisorValue, Inverse); }
+        }
+        _mm512_storeu_si512((void*)(Remainders + (Lane - Begin)), Sum);
+    }
+}
+
+static const batch_kernels BatchKernelsAVX512 =
+{
+    "avx512", BatchAddAVX512, BatchSubtractAVX512, BatchLessAVX512, BatchEqualAVX512, BatchRemainderByPartAVX512,
+};
+
+// Best instruction set the CPU and OS both support.
+static batch_isa
+BatchDetectISA()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int Info[4];
+    __cpuid(Info, 0);
+    int MaxLeaf = Info[0];
+    __cpuid(Info, 1);
+    bool OSXSave = (Info[2] & (1 << 27)) != 0;
+    bool AVX = (Info[2] & (1 << 28)) != 0;
+    if (!OSXSave || !AVX || MaxLeaf < 7) { return BatchISA_Scalar; }
+    // XCR0: SSE and AVX state (bits 1-2), plus opmask and ZMM state (bits 5-7).
+    uint64_t EnabledState = _xgetbv(0);
+    __cpuidex(Info, 7, 0);
+    if ((Info[1] & (1 << 16)) && (EnabledState & 0xE6) == 0xE6) { return BatchISA_AVX512; }
+    if ((Info[1] & (1 << 5)) && (EnabledState & 0x6) == 0x6) { return BatchISA_AVX2; }
+    return BatchISA_Scalar;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return BatchISA_AVX512; }
+    if (__builtin_cpu_supports("avx2")) { return BatchISA_AVX2; }
+    return BatchISA_Scalar;
+#endif
+}
+
+#else
+
+static batch_isa
+BatchDetectISA()
+{
+    return BatchISA_Scalar;
+}
+
+#endif
+
+static const batch_kernels*
+BatchKernelsFor(batch_isa ISA)
+{
+#if defined(BATCH_X64)
+    if (ISA == BatchISA_AVX512) { return &BatchKernelsAVX512; }
+    if (ISA == BatchISA_AVX2) { return &BatchKernelsAVX2; }
+#endif
+    return &BatchKernelsScalar;
+}
+
+static const batch_kernels* BatchForcedKernels = 0;
+
+inline const batch_kernels*
+BatchKernels()
+{
+    static const batch_kernels* Detected = BatchKernelsFor(BatchDetectISA());
+    return BatchForcedKernels ? BatchForcedKernels : Detected;
+}
+
+// Forces the kernels for ISA. Returns false, changing nothing, if this CPU
+// cannot run them. Not thread safe: call it before any batch work starts.
+static bool
+BatchUseKernels(batch_isa ISA)
+{
+    if (ISA > BatchDetectISA()) { return false; }
+    BatchForcedKernels = BatchKernelsFor(ISA);
+    return true;
+}
+
+//
+// Container
+//
+
+inline uint32_t
+BatchStride(uint32_t Count)
+{
+    return (Count + BATCH_BLOCK - 1) / BATCH_BLOCK * BATCH_BLOCK;
+}
+
+// Room for Count values, all zero. Rows start on 64-byte boundaries.
+template <uint32_t Bits>
+static void
+UIntBatchAllocate(uintn_batch<Bits>* Batch, uint32_t Count)
+{
+    Batch->Count = Count;
+    Batch->Stride = BatchStride(Count);
+    size_t Size = (size_t)uintn_batch<Bits>::PartCount * Batch->Stride * sizeof(uint64_t);
+#if defined(_MSC_VER)
+    Batch->Parts = (uint64_t*)_aligned_malloc(Size ? Size : 64, 64);
+#else
+    Batch->Parts = (uint64_t*)aligned_alloc(64, Size ? Size : 64);
+#endif
+    assert(Batch->Parts);
+    for (size_t Index = 0; Index < Size / sizeof(uint64_t); ++Index) { Batch->Parts[Index] = 0; }
+}
+
+template <uint32_t Bits>
+static void
+UIntBatchFree(uintn_batch<Bits>* Batch)
+{
+#if defined(_MSC_VER)
+    _aligned_free(Batch->Parts);
+#else
+    free(Batch->Parts);
+#endif
+    Batch->Parts = 0;
+    Batch->Count = Batch->Stride = 0;
+}
+
+template <uint32_t Bits>
+inline void
+UIntBatchSet(uintn_batch<Bits>* Batch, uint32_t Index, const uintn<Bits>& Value)
+{
+    assert(Index < Batch->Count);
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        Batch->Parts[(size_t)PartIndex * Batch->Stride + Index] = Value.Parts[PartIndex];
+    }
+}
+
+template <uint32_t Bits>
+inline uintn<Bits>
+UIntBatchGet(const uintn_batch<Bits>& Batch, uint32_t Index)
+{
+    assert(Index < Batch.Count);
+    uintn<Bits> Result;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        Result.Parts[PartIndex] = Batch.Parts[(size_t)PartIndex * Batch.Stride + Index];
+    }
+    return Result;
+}
+
+// Transposes Batch->Count values in from an ordinary array.
+template <uint32_t Bits>
+static void
+UIntBatchLoad(uintn_batch<Bits>* Batch, const uintn<Bits>* Values)
+{
+    // Part-major, so each row is written sequentially.
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        uint64_t* Row = Batch->Parts + (size_t)PartIndex * Batch->Stride;
+        for (uint32_t Index = 0; Index < Batch->Count; ++Index) { Row[Index] = Values[Index].Parts[PartIndex]; }
+    }
+}
+
+// Transposes the values back out into an ordinary array of Batch.Count.
+template <uint32_t Bits>
+static void
+UIntBatchStore(const uintn_batch<Bits>& Batch, uintn<Bits>* Values)
+{
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        const uint64_t* Row = Batch.Parts + (size_t)PartIndex * Batch.Stride;
+        for (uint32_t Index = 0; Index < Batch.Count; ++Index) { Values[Index].Parts[PartIndex] = Row[Index]; }
+    }
+}
+
+//
+// Element-wise operations. Operands and results all hold the same Count;
+// Result may be A or B. Arithmetic wraps mod 2^Bits like operator+ and
+// operator-.
+//
+
+template <uint32_t Bits>
+static void
+UIntBatchAdd(uintn_batch<Bits>* Result, const uintn_batch<Bits>& A, const uintn_batch<Bits>& B)
+{
+    assert(A.Count == B.Count && Result->Count == A.Count);
+    BatchKernels()->Add(Result->Parts, A.Parts, B.Parts, uintn<Bits>::PartCount, A.Stride);
+}
+
+template <uint32_t Bits>
+static void
+UIntBatchSubtract(uintn_batch<Bits>* Result, const uintn_batch<Bits>& A, const uintn_batch<Bits>& B)
+{
+    assert(A.Count == B.Count && Result->Count == A.Count);
+    BatchKernels()->Subtract(Result->Parts, A.Parts, B.Parts, uintn<Bits>::PartCount, A.Stride);
+}
+
+// Comparison results are bitmasks: bit (Index % 8) of Results[Index / 8] is
+// set when the comparison holds for value Index. Results needs (Count + 7) / 8
+// bytes; bits past Count come back clear.
+template <uint32_t Bits>
+static void
+UIntBatchLess(const uintn_batch<Bits>& A, const uintn_batch<Bits>& B, uint8_t* Results)
+{
+    assert(A.Count == B.Count);
+    BatchKernels()->Less(Results, A.Parts, B.Parts, uintn<Bits>::PartCount, A.Stride);
+}
+
+template <uint32_t Bits>
+static void
+UIntBatchEqual(const uintn_batch<Bits>& A, const uintn_batch<Bits>& B, uint8_t* Results)
+{
+    assert(A.Count == B.Count);
+    BatchKernels()->Equal(Results, A.Parts, B.Parts, uintn<Bits>::PartCount, A.Stride);
+    // Padding lanes are zero on both sides, so they compare equal.
+    if (A.Count % BATCH_BLOCK) { Results[A.Count / BATCH_BLOCK] &= (uint8_t)((1u << (A.Count % BATCH_BLOCK)) - 1); }
+}
+
+// Remainders[Index] = A[Index] % Divisor for every value. Divisors up to
+// BATCH_SMALL_DIVISOR_MAX use the digit weights (in vector registers where
+// there are any); larger ones walk each value with the preinverted divisor.
+template <uint32_t Bits>
+static void
+UIntBatchRemainderByPart(const uintn_batch<Bits>& A, uint64_t Divisor, uint64_t* Remainders)
+{
+    assert(Divisor != 0);
+    const int32_t DigitCount = 2 * uintn<Bits>::PartCount;
+    uint64_t Weights[DigitCount] = {};
+    batch_divisor Prepared = {};
+    Prepared.Divisor = Divisor;
+    Prepared.Preinverted = MakePartDivisor(Divisor);
+    Prepared.Inverse = 1.0 / (double)Divisor;
+    Prepared.Weights = Weights;
+    if (Divisor <= BATCH_SMALL_DIVISOR_MAX)
+    {
+        uint64_t Weight = 1 % Divisor;
+        uint64_t Radix = ((uint64_t)1 << 32) % Divisor;
+        for (int32_t Digit = 0; Digit < DigitCount; ++Digit, Weight = Weight * Radix % Divisor) { Weights[Digit] = Weight; }
+    }
+
+    const batch_kernels* Kernels = BatchKernels();
+    uint32_t WholeBlocks = A.Count / BATCH_BLOCK * BATCH_BLOCK;
+    Kernels->RemainderByPart(Remainders, A.Parts, uintn<Bits>::PartCount, A.Stride, 0, WholeBlocks, &Prepared);
+    if (WholeBlocks < A.Count)
+    {
+        uint64_t Tail[BATCH_BLOCK];
+        Kernels->RemainderByPart(Tail, A.Parts, uintn<Bits>::PartCount, A.Stride, WholeBlocks, A.Stride, &Prepared);
+        for (uint32_t Index = WholeBlocks; Index < A.Count; ++Index) { Remainders[Index] = Tail[Index - WholeBlocks]; }
+    }
+}
+
+#define BIGINT_BATCH_CPP
+#endif
@@ -0,0 +1,783 @@
+// Benchmarks for bigint.cpp. Builds without Win32, always measure optimized builds:
+//   cl /O2 /EHsc bigint_bench.cpp      (build.bat bench)
+//   g++ -O2 -pthread -o bigint_bench bigint_bench.cpp      (build.sh bench; add -march=native to tune)
+// By default runs the operation suite (ns and cycles per op, with
+// percentiles) as a table; --csv or --json for tracking runs over time,
+// --experiments for the tuning tables. --help lists the options.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <algorithm>
+#include "bigint.cpp"
+#include "bigint_parallel.cpp"
+#include "bigint_format.cpp"
+#include "bigint_batch.cpp"
+
+static uint64_t BenchRandomState = 0x9E3779B97F4A7C15;
+
+static uint64_t
+BenchRandom()
+{
+    // xorshift64*; only needs to produce dense operands, not good randomness.
+    BenchRandomState ^= BenchRandomState >> 12;
+    BenchRandomState ^= BenchRandomState << 25;
+    BenchRandomState ^= BenchRandomState >> 27;
+    return BenchRandomState * 0x2545F4914F6CDD1D;
+}
+
+static double
+NowNanoseconds()
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Times Kernel until at least 50ms have passed and returns nanoseconds per call.
+// Kernels feed part of each result back into their operands so the optimizer
+// can neither hoist nor drop the work being timed.
+template <typename kernel>
+static double
+NanosecondsPerCall(kernel Kernel)
+{
+    for (int Warmup = 0; Warmup < 100; ++Warmup) { Kernel(); }
+    uint64_t Calls = 0;
+    double Start = NowNanoseconds();
+    double Elapsed;
+    do
+    {
+        for (int Batch = 0; Batch < 100; ++Batch) { Kernel(); }
+        Calls += 100;
+        Elapsed = NowNanoseconds() - Start;
+    } while (Elapsed < 50e6);
+    return Elapsed / (double)Calls;
+}
+
+// Schoolbook (Comba) against a single Karatsuba split at the same limb count.
+// The crossover is the first row where the Karatsuba column wins; set
+// BIGINT_KARATSUBA_THRESHOLD to that limb count.
+template <int32_t Count>
+static void
+BenchKaratsubaCrossover()
+{
+    uint64_t A[Count], B[Count], Result[2 * Count];
+    for (int32_t Index = 0; Index < Count; ++Index) { A[Index] = BenchRandom(); B[Index] = BenchRandom(); }
+
+    double Comba = NanosecondsPerCall([&]() {
+        MultiplyLimbs<Count, 2 * Count>(Result, A, B); A[0] += Result[Count];
+    });
+    double Karatsuba = NanosecondsPerCall([&]() {
+        KaratsubaMultiplyLimbs<Count>(Result, A, B); A[0] += Result[Count];
+    });
+    double Comba2 = NanosecondsPerCall([&]() {
+        SquareLimbs<Count, 2 * Count>(Result, A); A[0] += Result[Count];
+    });
+    double Karatsuba2 = NanosecondsPerCall([&]() {
+        KaratsubaSquareLimbs<Count>(Result, A); A[0] += Result[Count];
+    });
+    printf("%6d %6d %12.1f %12.1f %12.1f %12.1f\n", Count * 64, Count,
+           Comba, Karatsuba, Comba2, Karatsuba2);
+}
+
+// Average wall time of a seeded 512-bit ParallelRandomPrime at doubling thread
+// counts. Every row finds the same primes, so the speedup column is pure scaling.
+static void
+BenchParallelPrimeSearch()
+{
+    const int SeedCount = 32;
+    uint32_t MaxThreads = ParallelDefaultThreadCount();
+    printf("\nParallelRandomPrime(512), ms per prime over %d seeds (%u hardware threads)\n", SeedCount, MaxThreads);
+    printf("%8s %12s %12s\n", "threads", "ms", "speedup");
+    double SingleThread = 0;
+    for (uint32_t ThreadCount = 1; ThreadCount <= MaxThreads; ThreadCount *= 2)
+    {
+        uint512 Check = 0;
+        double Start = NowNanoseconds();
+        for (int Seed = 1; Seed <= SeedCount; ++Seed)
+        {
+            Check += ParallelRandomPrime(512, (uint64_t)Seed, ThreadCount);
+        }
+        double Milliseconds = (NowNanoseconds() - Start) / (1e6 * SeedCount);
+        if (ThreadCount == 1) { SingleThread = Milliseconds; }
+        printf("%8u %12.2f %12.2f   (check %016llx)\n", ThreadCount, Milliseconds,
+               SingleThread / Milliseconds, (unsigned long long)Check.Parts[0]);
+        if (ThreadCount < MaxThreads && ThreadCount * 2 > MaxThreads) { ThreadCount = MaxThreads / 2; }
+    }
+}
+
+// Tests per second over a span of random 512-bit odd candidates with a share of
+// primes mixed in, one call at a time against the batch entry points.
+static void
+BenchPrimalityBatch()
+{
+    const uint32_t Count = 4096;
+    uint512* Candidates = new uint512[Count];
+    uint512* Results = new uint512[Count];
+    for (uint32_t Index = 0; Index < Count; ++Index)
+    {
+        if (Index % 8 == 0)
+        {
+            Candidates[Index] = ParallelRandomPrime(512, Index);
+            continue;
+        }
+        for (int32_t PartIndex = 0; PartIndex < UINT512_PARTS; ++PartIndex) { Candidates[Index].Parts[PartIndex] = BenchRandom(); }
+        Candidates[Index].Parts[0] |= 1;
+    }
+
+    printf("\nPrimality throughput, %u candidates (1 in 8 prime), tests per second\n", Count);
+    double Start = NowNanoseconds();
+    for (uint32_t Index = 0; Index < Count; ++Index) { Results[Index] = PrimalityTestBPSW(Candidates[Index]); }
+    printf("%28s %12.0f\n", "PrimalityTestBPSW", Count / ((NowNanoseconds() - Start) * 1e-9));
+    Start = NowNanoseconds();
+    PrimalityTestBatch(Candidates, Results, Count);
+    printf("%28s %12.0f\n", "PrimalityTestBatch", Count / ((NowNanoseconds() - Start) * 1e-9));
+    Start = NowNanoseconds();
+    PrimalityTestBatchParallel(Candidates, Results, Count);
+    printf("%28s %12.0f   (%u threads)\n", "PrimalityTestBatchParallel", Count / ((NowNanoseconds() - Start) * 1e-9),
+           ParallelDefaultThreadCount());
+
+    delete[] Candidates;
+    delete[] Results;
+}
+
+// Decimal and hex conversion of dense numbers, ns per call. The digit-at-a-time
+// row is the old driver approach (one UIntDivideByPart by 10 per digit) and
+// is the baseline for the chunked formatter.
+template <uint32_t Bits>
+static void
+BenchConversion()
+{
+    uintn<Bits> N;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { N.Parts[PartIndex] = BenchRandom(); }
+    char Decimal[UINTN_DECIMAL_DIGITS(Bits) + 1];
+    char Hex[UINTN_HEX_DIGITS(Bits) + 1];
+    uint32_t DecimalLength = UIntFormatDecimal(N, Decimal, sizeof(Decimal));
+    uint32_t HexLength = UIntFormatHex(N, Hex, sizeof(Hex));
+    uintn<Bits> Parsed;
+
+    double DigitAtATime = NanosecondsPerCall([&]() {
+        uintn<Bits> Rest = N;
+        uint64_t Digit;
+        for (uint32_t Index = DecimalLength; Index > 0; --Index)
+        {
+            Rest = UIntDivideByPart(Rest, 10, &Digit);
+            Decimal[Index - 1] = (char)('0' + Digit);
+        }
+        N.Parts[0] += Decimal[0];
+    });
+    double FormatDecimal = NanosecondsPerCall([&]() {
+        UIntFormatDecimal(N, Decimal, sizeof(Decimal)); N.Parts[0] += Decimal[0];
+    });
+    double FormatHex = NanosecondsPerCall([&]() {
+        UIntFormatHex(N, Hex, sizeof(Hex)); N.Parts[0] += Hex[0];
+    });
+    double ParseDecimal = NanosecondsPerCall([&]() {
+        UIntParseDecimal(Decimal, DecimalLength, &Parsed); Decimal[DecimalLength - 1] = (char)('0' + (Parsed.Parts[0] & 7));
+    });
+    double ParseHex = NanosecondsPerCall([&]() {
+        UIntParseHex(Hex, HexLength, &Parsed); Hex[HexLength - 1] = (char)('0' + (Parsed.Parts[0] & 7));
+    });
+    printf("%6u %12.1f %12.1f %12.1f %12.1f %12.1f\n", Bits,
+           DigitAtATime, FormatDecimal, FormatHex, ParseDecimal, ParseHex);
+}
+
+// Bulk random parts, ns per 64-bit part, against the four rand() calls per part
+// that Random512 used to make.
+static void
+BenchRandomFill()
+{
+    const uint32_t Count = 512;
+    uint64_t Parts[Count];
+    random_xoshiro256 Xoshiro;
+    XoshiroSeed(&Xoshiro, 1);
+    random_chacha20 ChaCha;
+    ChaChaSeed(&ChaCha, (uint64_t)1, 0);
+
+    double LibC = NanosecondsPerCall([&]() {
+        for (uint32_t Index = 0; Index < Count; ++Index)
+        {
+            Parts[Index] = ((uint64_t)rand() | (uint64_t)rand() << 16 |
+                            (uint64_t)rand() << 32 | (uint64_t)rand() << 48);
+        }
+    });
+    double Xoshiro256 = NanosecondsPerCall([&]() { RandomFill(&Xoshiro, Parts, Count); });
+    double ChaCha20 = NanosecondsPerCall([&]() { RandomFill(&ChaCha, Parts, Count); });
+    printf("\nRandom parts, ns per part\n");
+    printf("%12s %12s %12s\n", "rand() x4", "xoshiro256", "chacha20");
+    printf("%12.2f %12.2f %12.2f   (check %016llx)\n", LibC / Count, Xoshiro256 / Count, ChaCha20 / Count,
+           (unsigned long long)Parts[0]);
+}
+
+// Copying two-operand forms against the in-place operators, ns per call. Each
+// pair does the same arithmetic; the difference is the temporaries the copying
+// form builds and stores back.
+template <uint32_t Bits>
+static void
+BenchInPlace()
+{
+    uintn<Bits> A, B, C;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+    {
+        A.Parts[PartIndex] = BenchRandom(); B.Parts[PartIndex] = BenchRandom(); C.Parts[PartIndex] = BenchRandom();
+    }
+
+    double Copy = NanosecondsPerCall([&]() { A = A + B; A = A >> 1; A = A - C; });
+    double InPlace = NanosecondsPerCall([&]() { A += B; A >>= 1; A -= C; });
+    double CopyPart = NanosecondsPerCall([&]() { A = A + 2; });
+    double InPlacePart = NanosecondsPerCall([&]() { A += 2; });
+    double CopyAddMul = NanosecondsPerCall([&]() { A = A + B * C; B.Parts[0] ^= A.Parts[0]; });
+    double AddMul = NanosecondsPerCall([&]() { UIntAddMul(&A, B, C); B.Parts[0] ^= A.Parts[0]; });
+    printf("%6u %12.2f %12.2f %12.2f %12.2f %12.1f %12.1f   (check %016llx)\n", Bits,
+           Copy, InPlace, CopyPart, InPlacePart, CopyAddMul, AddMul, (unsigned long long)A.Parts[0]);
+}
+
+// Element-wise work over 4096 values, ns per value: a plain loop over uintn
+// arrays against the SoA batch kernels for each instruction set this CPU runs.
+template <uint32_t Bits>
+static void
+BenchBatch()
+{
+    const uint32_t Count = 4096;
+    uintn<Bits>* X = new uintn<Bits>[Count];
+    uintn<Bits>* Y = new uintn<Bits>[Count];
+    uintn<Bits>* Z = new uintn<Bits>[Count];
+    for (uint32_t Index = 0; Index < Count; ++Index)
+    {
+        for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex)
+        {
+            X[Index].Parts[PartIndex] = BenchRandom(); Y[Index].Parts[PartIndex] = BenchRandom();
+        }
+    }
+    uint8_t Masks[Count / 8];
+    uint64_t Remainders[Count];
+    uint64_t Check = 0;
+
+    double Add = NanosecondsPerCall([&]() { for (uint32_t Index = 0; Index < Count; ++Index) { Z[Index] = X[Index] + Y[Index]; } });
+    double Subtract = NanosecondsPerCall([&]() { for (uint32_t Index = 0; Index < Count; ++Index) { Z[Index] = X[Index] - Y[Index]; } });
+    double Less = NanosecondsPerCall([&]() {
+        for (uint32_t Index = 0; Index < Count; Index += 8)
+        {
+            uint8_t Mask = 0;
+            for (uint32_t Lane = 0; Lane < 8; ++Lane) { Mask |= (uint8_t)((X[Index + Lane] < Y[Index + Lane]) << Lane); }
+            Masks[Index / 8] = Mask;
+        }
+    });
+    double Equal = NanosecondsPerCall([&]() {
+        for (uint32_t Index = 0; Index < Count; Index += 8)
+        {
+            uint8_t Mask = 0;
+            for (uint32_t Lane = 0; Lane < 8; ++Lane) { Mask |= (uint8_t)((X[Index + Lane] == Y[Index + Lane]) << Lane); }
+            Masks[Index / 8] = Mask;
+        }
+    });
+    part_divisor Divisor = MakePartDivisor(65521);
+    double Remainder = NanosecondsPerCall([&]() {
+        for (uint32_t Index = 0; Index < Count; ++Index) { Remainders[Index] = UIntRemainderByPart(X[Index], &Divisor); }
+    });
+    Check += Z[0].Parts[0] + Masks[0] + Remainders[0];
+    printf("%6u %10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", Bits, "uintn",
+           Add / Count, Subtract / Count, Less / Count, Equal / Count, Remainder / Count);
+
+    uintn_batch<Bits> A, B, C;
+    UIntBatchAllocate(&A, Count); UIntBatchAllocate(&B, Count); UIntBatchAllocate(&C, Count);
+    UIntBatchLoad(&A, X); UIntBatchLoad(&B, Y);
+    for (int ISA = BatchISA_Scalar; ISA <= BatchISA_AVX512; ++ISA)
+    {
+        if (!BatchUseKernels((batch_isa)ISA)) { continue; }
+        Add = NanosecondsPerCall([&]() { UIntBatchAdd(&C, A, B); });
+        Subtract = NanosecondsPerCall([&]() { UIntBatchSubtract(&C, A, B); });
+        Less = NanosecondsPerCall([&]() { UIntBatchLess(A, B, Masks); });
+        Equal = NanosecondsPerCall([&]() { UIntBatchEqual(A, B, Masks); });
+        Remainder = NanosecondsPerCall([&]() { UIntBatchRemainderByPart(A, 65521, Remainders); });
+        Check += C.Parts[0] + Masks[0] + Remainders[0];
+        printf("%6u %10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", Bits, BatchKernels()->Name,
+               Add / Count, Subtract / Count, Less / Count, Equal / Count, Remainder / Count);
+    }
+    BatchUseKernels(BatchDetectISA());
+    printf("%6s (check %016llx)\n", "", (unsigned long long)Check);
+
+    UIntBatchFree(&A); UIntBatchFree(&B); UIntBatchFree(&C);
+    delete[] X;
+    delete[] Y;
+    delete[] Z;
+}
+
+// XOR of every part, so a kernel that feeds one bit of a result back still
+// needs all of it computed.
+template <uint32_t Bits>
+static uint64_t
+BenchFold(const uintn<Bits>& A)
+{
+    uint64_t Result = 0;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { Result ^= A.Parts[PartIndex]; }
+    return Result;
+}
+
+// Plain uintn against uintn_tracked on operands with ActivePartCount parts in
+// use, ns per call. The narrow rows are the counters and remainders tracking is
+// for; the full-width row is what it costs when values are dense. "add" is +=
+// and a -= that undoes it, so the operands keep their size.
+template <uint32_t Bits>
+static void
+BenchTracked(int32_t ActivePartCount)
+{
+    uintn<Bits> A, B;
+    for (int32_t PartIndex = 0; PartIndex < ActivePartCount; ++PartIndex)
+    {
+        A.Parts[PartIndex] = BenchRandom(); B.Parts[PartIndex] = BenchRandom();
+    }
+    A.Parts[ActivePartCount - 1] >>= 1;
+    B.Parts[ActivePartCount - 1] >>= 2;
+    uintn<Bits> R = A;
+    uintn_tracked<Bits> TA = A, TB = B, TR = A;
+
+    double Add = NanosecondsPerCall([&]() { A += B; A -= B; });
+    double TrackedAdd = NanosecondsPerCall([&]() { TA += TB; TA -= TB; });
+    double Less = NanosecondsPerCall([&]() { B.Parts[0] ^= (A < B); });
+    double TrackedLess = NanosecondsPerCall([&]() { TB.Value.Parts[0] ^= (TA < TB); });
+    double Multiply = NanosecondsPerCall([&]() { R = A * B; B.Parts[0] ^= BenchFold(R) & 2; });
+    double TrackedMultiply = NanosecondsPerCall([&]() { TR = TA * TB; TB.Value.Parts[0] ^= BenchFold(TR.Value) & 2; });
+    double Remainder = NanosecondsPerCall([&]() { R = A % B; A.Parts[0] ^= BenchFold(R) & 2; });
+    double TrackedRemainder = NanosecondsPerCall([&]() { TR = TA % TB; TA.Value.Parts[0] ^= BenchFold(TR.Value) & 2; });
+    printf("%6u %6d %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f   (check %016llx)\n", Bits, ActivePartCount,
+           Add, TrackedAdd, Less, TrackedLess, Multiply, TrackedMultiply, Remainder, TrackedRemainder,
+           (unsigned long long)(BenchFold(R) ^ BenchFold(TR.Value)));
+}
+
+// Fixed moduli whose Montgomery contexts are built entirely at compile time.
+// The table shows the setup each one would otherwise cost at startup.
+static constexpr uint256 BenchP256 = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF_u256;
+static constexpr montgomery_context<256> BenchP256Context = MakeMontgomeryContext(BenchP256);
+// 2^512 - 569, the largest 512-bit prime.
+static constexpr uint512 BenchP512 = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFDC7_u512;
+static constexpr montgomery_context<512> BenchP512Context = MakeMontgomeryContext(BenchP512);
+
+template <uint32_t Bits>
+static void
+BenchFixedModulus(const char* Name, const montgomery_context<Bits>* Fixed)
+{
+    uintn<Bits> Modulus = Fixed->Modulus;
+    montgomery_context<Bits> Context = {};
+    // Volatile so the setup of a modulus the compiler can see is not folded away.
+    volatile uint64_t Zero = 0;
+    volatile uint64_t Sink = 0;
+    double Setup = NanosecondsPerCall([&]() {
+        Modulus.Parts[1] ^= Zero;
+        MontgomeryInit(&Context, Modulus);
+        Sink = Context.One.Parts[0] ^ Context.RSquared.Parts[0] ^ Context.NPrime;
+    });
+    uintn<Bits> Base = 3;
+    double Power = NanosecondsPerCall([&]() { Base = PowMod(Fixed, Base, Fixed->Modulus - 1); });
+    printf("%10s %14.1f %14.1f   (check %016llx)\n", Name, Setup, Power, (unsigned long long)Base.Parts[0]);
+}
+
+// The tuning tables: each one compares alternatives for a single decision
+// (thresholds, kernels, representations) rather than tracking the library.
+static void
+RunExperiments()
+{
+    printf("Wide multiply / square, ns per call (threshold = %d limbs)\n", BIGINT_KARATSUBA_THRESHOLD);
+    printf("%6s %6s %12s %12s %12s %12s\n", "bits", "limbs", "mul comba", "mul karat", "sqr comba", "sqr karat");
+    BenchKaratsubaCrossover<4>();
+    BenchKaratsubaCrossover<6>();
+    BenchKaratsubaCrossover<8>();
+    BenchKaratsubaCrossover<12>();
+    BenchKaratsubaCrossover<16>();
+    BenchKaratsubaCrossover<24>();
+    BenchKaratsubaCrossover<32>();
+    BenchKaratsubaCrossover<48>();
+    BenchKaratsubaCrossover<64>();
+    BenchKaratsubaCrossover<128>();
+    printf("\nCopying vs in-place operators, ns per call\n");
+    printf("%6s %12s %12s %12s %12s %12s %12s\n", "bits", "a=a+b>>1-c", "+= >>= -=", "a=a+2", "a+=2", "a=a+b*c", "AddMul");
+    BenchInPlace<256>();
+    BenchInPlace<512>();
+    BenchInPlace<1024>();
+    BenchInPlace<2048>();
+    printf("\nPlain vs tracked active parts, ns per call\n");
+    printf("%6s %6s %8s %8s %8s %8s %8s %8s %8s %8s\n", "bits", "active", "add", "trk add", "less", "trk less",
+           "mul", "trk mul", "mod", "trk mod");
+    BenchTracked<512>(1);
+    BenchTracked<512>(2);
+    BenchTracked<512>(4);
+    BenchTracked<512>(8);
+    BenchTracked<1024>(1);
+    BenchTracked<1024>(2);
+    BenchTracked<1024>(16);
+    printf("\nFixed moduli, ns (MontgomeryInit is the startup a constexpr context avoids)\n");
+    printf("%10s %14s %14s\n", "modulus", "MontgomeryInit", "PowMod");
+    BenchFixedModulus("P-256", &BenchP256Context);
+    BenchFixedModulus("2^512-569", &BenchP512Context);
+    printf("\nBatch element-wise ops over 4096 values, ns per value (mod is by 65521)\n");
+    printf("%6s %10s %10s %10s %10s %10s %10s\n", "bits", "kernels", "add", "sub", "less", "equal", "mod");
+    BenchBatch<256>();
+    BenchBatch<512>();
+    BenchBatch<1024>();
+    printf("\nText conversion, ns per call\n");
+    printf("%6s %12s %12s %12s %12s %12s\n", "bits", "dec (old)", "dec format", "hex format", "dec parse", "hex parse");
+    BenchConversion<128>();
+    BenchConversion<256>();
+    BenchConversion<512>();
+    BenchConversion<1024>();
+    BenchRandomFill();
+    BenchParallelPrimeSearch();
+    BenchPrimalityBatch();
+}
+
+// OPERATION SUITE:
+// One row per operation and operand size, for tracking regressions and
+// speedups over time. Each row warms the operation up, sizes a sample so it
+// runs for at least BenchOptions.SampleNanoseconds, then takes up to
+// BenchOptions.Repetitions samples within BenchOptions.BudgetNanoseconds.
+// Wall time per op comes from steady_clock and cycles per op from the time
+// stamp counter; the TSC ticks at a fixed reference rate, so cycles read high
+// or low when the core runs off its base clock. Operands rotate through a
+// pool of BENCH_POOL values and results are stored back to a pool, so nothing
+// can be hoisted or dropped.
+#define BENCH_POOL 64          // Operands per pool, a power of two
+#define BENCH_PRIME_POOL 16    // Primes per primality pool
+#define BENCH_MIN_SAMPLES 11   // Taken even when the budget runs out first
+
+enum bench_format
+{
+    BenchFormat_Text,
+    BenchFormat_CSV,
+    BenchFormat_JSON,
+};
+
+struct bench_options
+{
+    bench_format Format;
+    const char* Filter;         // Only operations whose name contains this
+    uint32_t Repetitions;       // Samples per row, at most
+    double WarmupNanoseconds;
+    double SampleNanoseconds;   // Minimum length of one sample
+    double BudgetNanoseconds;   // Per row, once BENCH_MIN_SAMPLES are in
+};
+
+static bench_options BenchOptions = { BenchFormat_Text, 0, 101, 20e6, 20e3, 500e6 };
+static uint32_t BenchRowCount = 0;
+static volatile uint64_t BenchSink = 0;
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define BENCH_HAS_CYCLES 1
+#if !defined(_MSC_VER)
+#include <x86intrin.h>
+#endif
+#endif
+
+// Without a cycle counter the cycle columns read 0.
+#if defined(BENCH_HAS_CYCLES)
+static const bool BenchCyclesAvailable = true;
+#else
+static const bool BenchCyclesAvailable = false;
+#endif
+
+static uint64_t
+BenchCycles()
+{
+#if defined(BENCH_HAS_CYCLES)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Nearest-rank percentile of Count sorted samples.
+static double
+BenchPercentile(const double* Sorted, uint32_t Count, double Fraction)
+{
+    uint32_t Rank = (uint32_t)(Fraction * Count + 0.999999);
+    if (Rank < 1) { Rank = 1; }
+    if (Rank > Count) { Rank = Count; }
+    return Sorted[Rank - 1];
+}
+
+static void
+BenchPrintHeader()
+{
+    if (BenchOptions.Format == BenchFormat_CSV)
+    {
+        printf("operation,bits,ops_per_sample,samples,ns_min,ns_median,ns_p90,ns_p99,ns_mean,cycles_median\n");
+    }
+    else if (BenchOptions.Format == BenchFormat_JSON)
+    {
+        printf("{\n  \"cycles_available\": %s,\n  \"results\": [", BenchCyclesAvailable ? "true" : "false");
+    }
+    else
+    {
+        printf("ns and TSC cycles per operation; percentiles over samples of at least %.0f us\n",
+               BenchOptions.SampleNanoseconds * 1e-3);
+        printf("%-18s %6s %10s %7s %12s %12s %12s %12s %12s %12s\n", "operation", "bits", "ops/sample", "samples",
+               "ns min", "ns median", "ns p90", "ns p99", "ns mean", "cyc median");
+    }
+}
+
+static void
+BenchPrintFooter()
+{
+    if (BenchOptions.Format == BenchFormat_JSON) { printf("\n  ]\n}\n"); }
+}
+
+static void
+BenchPrintRow(const char* Operation, uint32_t Bits, uint64_t OpsPerSample, uint32_t Samples,
+              double Min, double Median, double P90, double P99, double Mean, double CyclesMedian)
+{
+    if (BenchOptions.Format == BenchFormat_CSV)
+    {
+        printf("%s,%u,%llu,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f\n", Operation, Bits, (unsigned long long)OpsPerSample,
+               Samples, Min, Median, P90, P99, Mean, CyclesMedian);
+    }
+    else if (BenchOptions.Format == BenchFormat_JSON)
+    {
+        printf("%s\n    {\"operation\": \"%s\", \"bits\": %u, \"ops_per_sample\": %llu, \"samples\": %u, "
+               "\"ns_min\": %.3f, \"ns_median\": %.3f, \"ns_p90\": %.3f, \"ns_p99\": %.3f, \"ns_mean\": %.3f, "
+               "\"cycles_median\": %.1f}", BenchRowCount ? "," : "", Operation, Bits, (unsigned long long)OpsPerSample,
+               Samples, Min, Median, P90, P99, Mean, CyclesMedian);
+    }
+    else
+    {
+        printf("%-18s %6u %10llu %7u %12.2f %12.2f %12.2f %12.2f %12.2f %12.1f\n", Operation, Bits,
+               (unsigned long long)OpsPerSample, Samples, Min, Median, P90, P99, Mean, CyclesMedian);
+    }
+    fflush(stdout);
+    ++BenchRowCount;
+}
+
+// Times Kernel(Index) for increasing Index and prints one row.
+template <typename kernel>
+static void
+BenchOperation(const char* Operation, uint32_t Bits, kernel Kernel)
+{
+    if (BenchOptions.Filter && !strstr(Operation, BenchOptions.Filter)) { return; }
+
+    // Warm-up doubles as calibration: grow the sample until it is long
+    // enough to swamp the clock reads, and keep going until warm.
+    uint32_t Index = 0;
+    uint64_t OpsPerSample = 1;
+    double WarmupStart = NowNanoseconds();
+    for (;;)
+    {
+        double Start = NowNanoseconds();
+        for (uint64_t Op = 0; Op < OpsPerSample; ++Op) { Kernel(Index++); }
+        double Elapsed = NowNanoseconds() - Start;
+        if (Elapsed < BenchOptions.SampleNanoseconds) { OpsPerSample *= 2; }
+        else if (NowNanoseconds() - WarmupStart >= BenchOptions.WarmupNanoseconds) { break; }
+    }
+
+    double* Nanoseconds = new double[BenchOptions.Repetitions];
+    double* Cycles = new double[BenchOptions.Repetitions];
+    uint32_t Samples = 0;
+    double Total = 0;
+    double BudgetStart = NowNanoseconds();
+    while (Samples < BenchOptions.Repetitions &&
+           (Samples < BENCH_MIN_SAMPLES || NowNanoseconds() - BudgetStart < BenchOptions.BudgetNanoseconds))
+    {
+        double Start = NowNanoseconds();
+        uint64_t StartCycles = BenchCycles();
+        for (uint64_t Op = 0; Op < OpsPerSample; ++Op) { Kernel(Index++); }
+        uint64_t EndCycles = BenchCycles();
+        double End = NowNanoseconds();
+        Nanoseconds[Samples] = (End - Start) / (double)OpsPerSample;
+        Cycles[Samples] = (double)(EndCycles - StartCycles) / (double)OpsPerSample;
+        Total += Nanoseconds[Samples];
+        ++Samples;
+    }
+    std::sort(Nanoseconds, Nanoseconds + Samples);
+    std::sort(Cycles, Cycles + Samples);
+    BenchPrintRow(Operation, Bits, OpsPerSample, Samples, Nanoseconds[0],
+                  BenchPercentile(Nanoseconds, Samples, 0.5), BenchPercentile(Nanoseconds, Samples, 0.9),
+                  BenchPercentile(Nanoseconds, Samples, 0.99), Total / Samples, BenchPercentile(Cycles, Samples, 0.5));
+    delete[] Nanoseconds;
+    delete[] Cycles;
+}
+
+template <uint32_t Bits>
+static uintn<Bits>
+BenchRandomUInt(uint32_t BitCount)
+{
+    uintn<Bits> Result;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { Result.Parts[PartIndex] = BenchRandom(); }
+    Result >>= Bits - BitCount;
+    SetBitAt(&Result, BitCount - 1, true);
+    return Result;
+}
+
+// Dense full-width operands throughout. Division is by a half-width divisor
+// (Algorithm D doing real work) and by a single part; powmod is a full-width
+// exponent modulo an odd full-width modulus.
+template <uint32_t Bits>
+static void
+BenchSuiteArithmetic()
+{
+    const uint32_t Mask = BENCH_POOL - 1;
+    uintn<Bits>* X = new uintn<Bits>[BENCH_POOL];
+    uintn<Bits>* Y = new uintn<Bits>[BENCH_POOL];
+    uintn<Bits>* Half = new uintn<Bits>[BENCH_POOL];
+    uintn<Bits>* Z = new uintn<Bits>[BENCH_POOL];
+    uint64_t Parts[BENCH_POOL];
+    uint32_t Shifts[BENCH_POOL];
+    uint32_t Lengths[BENCH_POOL];
+    char Text[UINTN_DECIMAL_DIGITS(Bits) + 1];
+    for (uint32_t Index = 0; Index < BENCH_POOL; ++Index)
+    {
+        X[Index] = BenchRandomUInt<Bits>(Bits);
+        Y[Index] = BenchRandomUInt<Bits>(Bits);
+        Half[Index] = BenchRandomUInt<Bits>(Bits / 2);
+        Parts[Index] = BenchRandom() | 1;
+        Shifts[Index] = (uint32_t)(BenchRandom() % Bits);
+    }
+    uintn<Bits> Modulus = X[0];
+    Modulus.Parts[0] |= 1;
+    montgomery_context<Bits> Context;
+    MontgomeryInit(&Context, Modulus);
+
+    BenchOperation("add", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] + Y[I & Mask]; });
+    BenchOperation("sub", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] - Y[I & Mask]; });
+    BenchOperation("mul", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] * Y[I & Mask]; });
+    BenchOperation("mul-wide", Bits, [&](uint32_t I) {
+        uintn<2 * Bits> Wide = UIntMultiplyWide(X[I & Mask], Y[I & Mask]); Z[I & Mask].Parts[0] = Wide.Parts[0] ^ Wide.Parts[uintn<Bits>::PartCount];
+    });
+    BenchOperation("div", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] / Half[I & Mask]; });
+    BenchOperation("mod", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] % Half[I & Mask]; });
+    BenchOperation("div-part", Bits, [&](uint32_t I) {
+        uint64_t Remainder; Z[I & Mask] = UIntDivideByPart(X[I & Mask], Parts[I & Mask], &Remainder); Z[I & Mask].Parts[0] ^= Remainder;
+    });
+    BenchOperation("shl", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] << Shifts[I & Mask]; });
+    BenchOperation("shr", Bits, [&](uint32_t I) { Z[I & Mask] = X[I & Mask] >> Shifts[I & Mask]; });
+    BenchOperation("print", Bits, [&](uint32_t I) { Lengths[I & Mask] = UIntFormatDecimal(X[I & Mask], Text, sizeof(Text)); });
+    BenchOperation("sqrt", Bits, [&](uint32_t I) { Z[I & Mask] = UIntSquareRoot(X[I & Mask]); });
+    BenchOperation("powmod", Bits, [&](uint32_t I) { Z[I & Mask] = PowMod(&Context, Half[I & Mask], Y[I & Mask]); });
+
+    for (uint32_t Index = 0; Index < BENCH_POOL; ++Index) { BenchSink = BenchSink + Z[Index].Parts[0] + Lengths[Index]; }
+    delete[] X;
+    delete[] Y;
+    delete[] Half;
+    delete[] Z;
+}
+
+// The primality tests on PrimeBits-bit primes, where every test runs to the
+// end (composites mostly leave at trial division). Pollard rho is timed on
+// semiprimes of the same size with a 32-bit smallest factor.
+static void
+BenchSuitePrimality(uint32_t PrimeBits)
+{
+    const uint32_t Mask = BENCH_PRIME_POOL - 1;
+    uint512 Primes[BENCH_PRIME_POOL];
+    uint512 Semiprimes[BENCH_PRIME_POOL];
+    uint512 Results[BENCH_PRIME_POOL];
+    random_xoshiro256 Generator;
+    XoshiroSeed(&Generator, PrimeBits);
+    for (uint32_t Index = 0; Index < BENCH_PRIME_POOL; ++Index)
+    {
+        Primes[Index] = RandomPrime(PrimeBits, &Generator);
+        Semiprimes[Index] = RandomPrime(32, &Generator) * RandomPrime(PrimeBits - 32, &Generator);
+    }
+
+    BenchOperation("trial-division", PrimeBits, [&](uint32_t I) { Results[I & Mask] = PrimalityTestEarlyOut(Primes[I & Mask]); });
+    BenchOperation("miller-rabin-20", PrimeBits, [&](uint32_t I) {
+        Results[I & Mask] = PrimalityTestRandom(Primes[I & Mask], 20, &Generator);
+    });
+    BenchOperation("bpsw", PrimeBits, [&](uint32_t I) { Results[I & Mask] = PrimalityTestBPSW(Primes[I & Mask]); });
+    BenchOperation("pollard-rho", PrimeBits, [&](uint32_t I) { Results[I & Mask] = PrimalityTestPollardRho(Semiprimes[I & Mask]); });
+
+    for (uint32_t Index = 0; Index < BENCH_PRIME_POOL; ++Index) { BenchSink = BenchSink + Results[Index].Parts[0]; }
+}
+
+static void
+RunSuite()
+{
+    BenchPrintHeader();
+    BenchSuiteArithmetic<256>();
+    BenchSuiteArithmetic<512>();
+    BenchSuiteArithmetic<1024>();
+    BenchSuiteArithmetic<2048>();
+    BenchSuitePrimality(128);
+    BenchSuitePrimality(256);
+    BenchSuitePrimality(512);
+    BenchPrintFooter();
+}
+
+#if defined(BIGINT_STATS)
+// Totals from the operation counters over the whole run, on stderr so the
+// CSV/JSON on stdout stays parseable. Bit lengths are shown as the populated
+// histogram buckets, "bucket upper bound:count".
+static void
+BenchPrintStats()
+{
+    static const char* OpNames[BigintOp_Count] =
+    {
+        "add", "subtract", "multiply", "multiply-wide", "square", "add-mul", "divide", "modulo",
+        "UIntDivision", "divide-by-part", "remainder-by-part", "less", "equal", "shift-left",
+        "shift-right", "montgomery-mul", "montgomery-square",
+    };
+    static const char* LoopNames[BigintLoop_Count] =
+    {
+        "limb products", "quotient digits", "quotient corrections", "add-backs", "part divides",
+    };
+    bigint_stats Stats = BigintStatsSnapshot();
+    fprintf(stderr, "\noperation counters:\n");
+    for (int32_t Op = 0; Op < BigintOp_Count; ++Op)
+    {
+        if (Stats.Calls[Op] == 0) { continue; }
+        fprintf(stderr, "%-18s %14llu  bits", OpNames[Op], (unsigned long long)Stats.Calls[Op]);
+        for (int32_t Bucket = 0; Bucket < BIGINT_STATS_BUCKETS; ++Bucket)
+        {
+            if (Stats.LeftBits[Op][Bucket] == 0) { continue; }
+            fprintf(stderr, " %d:%llu", Bucket * BIGINT_STATS_BUCKET_BITS, (unsigned long long)Stats.LeftBits[Op][Bucket]);
+        }
+        fprintf(stderr, "\n");
+    }
+    for (int32_t Loop = 0; Loop < BigintLoop_Count; ++Loop)
+    {
+        fprintf(stderr, "%-21s %14llu\n", LoopNames[Loop], (unsigned long long)Stats.Iterations[Loop]);
+    }
+}
+#endif
+
+static void
+PrintUsage(const char* Program)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --csv | --json        machine-readable suite output (default: table)\n"
+            "  --filter TEXT         only operations whose name contains TEXT\n"
+            "  --repetitions N       samples per row, at most (default %u)\n"
+            "  --budget-ms N         time per row once %d samples are in (default %.0f)\n"
+            "  --experiments         run the tuning tables instead of the suite\n",
+            Program, BenchOptions.Repetitions, BENCH_MIN_SAMPLES, BenchOptions.BudgetNanoseconds * 1e-6);
+}
+
+int main(int ArgCount, char* ArgValues[])
+{
+    bool Experiments = false;
+    for (int ArgIndex = 1; ArgIndex < ArgCount; ++ArgIndex)
+    {
+        const char* Arg = ArgValues[ArgIndex];
+        bool HasValue = ArgIndex + 1 < ArgCount;
+        if (strcmp(Arg, "--csv") == 0) { BenchOptions.Format = BenchFormat_CSV; }
+        else if (strcmp(Arg, "--json") == 0) { BenchOptions.Format = BenchFormat_JSON; }
+        else if (strcmp(Arg, "--experiments") == 0) { Experiments = true; }
+        else if (strcmp(Arg, "--filter") == 0 && HasValue) { BenchOptions.Filter = ArgValues[++ArgIndex]; }
+        else if (strcmp(Arg, "--repetitions") == 0 && HasValue && atoi(ArgValues[ArgIndex + 1]) > 0)
+        {
+            BenchOptions.Repetitions = (uint32_t)atoi(ArgValues[++ArgIndex]);
+        }
+        else if (strcmp(Arg, "--budget-ms") == 0 && HasValue && atoi(ArgValues[ArgIndex + 1]) > 0)
+        {
+            BenchOptions.BudgetNanoseconds = atoi(ArgValues[++ArgIndex]) * 1e6;
+        }
+        else
+        {
+            PrintUsage(ArgValues[0]);
+            return (strcmp(Arg, "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    if (Experiments) { RunExperiments(); }
+    else { RunSuite(); }
+#if defined(BIGINT_STATS)
+    BenchPrintStats();
+#endif
+    return 0;
+}
@@ -0,0 +1,227 @@
+// Command-line front end for the prime search and factoring code. Builds with
+// any of the toolchains (./build.sh driver, build.bat driver); timing uses
+// std::chrono so there is nothing OS-specific in it.
+//
+// With no command it does what windows_bigint_test.cpp does: finds a random
+// 512-bit prime and checks it again with Baillie-PSW, timing both.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include "bigint.cpp"
+#include "bigint_parallel.cpp"
+#include "bigint_format.cpp"
+
+struct driver_options
+{
+    uint64_t Seed;
+    bool Seeded;
+    uint32_t ThreadCount; // 0 = one per hardware thread
+    bool Time;
+};
+
+typedef std::chrono::steady_clock driver_clock;
+
+static void
+PrintUInt512(uint512 N, bool NewLine = false)
+{
+    char Buf[UINTN_DECIMAL_DIGITS(512) + 1];
+    UIntFormatDecimal(N, Buf, sizeof(Buf));
+    printf(NewLine ? "%s\n" : "%s", Buf);
+}
+
+static void
+PrintElapsed(const char* Name, driver_clock::time_point Start)
+{
+    double Milliseconds = std::chrono::duration<double, std::milli>(driver_clock::now() - Start).count();
+    fprintf(stderr, "Elapsed (%s): %.3f ms\n", Name, Milliseconds);
+}
+
+// Decimal, or hex with a 0x prefix.
+static bool
+ParseUInt512(const char* Text, uint512* Result)
+{
+    uint32_t Length = (uint32_t)strlen(Text);
+    if (Length > 2 && Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+    {
+        return UIntParseHex(Text, Length, Result);
+    }
+    return UIntParseDecimal(Text, Length, Result);
+}
+
+static int
+CommandPrime(uint32_t Bits, const driver_options* Options)
+{
+    if (Bits < 2 || Bits > 512)
+    {
+        fprintf(stderr, "prime: BITS must be between 2 and 512\n");
+        return 1;
+    }
+    driver_clock::time_point Start = driver_clock::now();
+    uint512 Prime = ParallelRandomPrime(Bits, Options->Seed, Options->ThreadCount);
+    PrintUInt512(Prime, true);
+    if (Options->Time) { PrintElapsed("prime", Start); }
+    return 0;
+}
+
+static int
+CommandNext(uint512 N, const driver_options* Options)
+{
+    driver_clock::time_point Start = driver_clock::now();
+    uint512 Prime = ParallelNextPrime(N, Options->ThreadCount);
+    if (Prime == 0)
+    {
+        fprintf(stderr, "next: no probable prime between N and 2^512\n");
+        return 1;
+    }
+    PrintUInt512(Prime, true);
+    if (Options->Time) { PrintElapsed("next", Start); }
+    return 0;
+}
+
+// Prints "prime"; "composite" and the smallest prime factor when trial division
+// found one; or just "composite" when Baillie-PSW proved it without a factor
+// (use factor for those). Exit code 0 for prime, 2 otherwise.
+static int
+CommandTest(uint512 N, const driver_options* Options)
+{
+    driver_clock::time_point Start = driver_clock::now();
+    uint512 Factor = PrimalityTestBPSW(N);
+    if (Factor == 1) { printf("prime\n"); }
+    else if (N <= 1) { printf("neither prime nor composite\n"); }
+    else if (Factor == 0) { printf("composite\n"); }
+    else
+    {
+        printf("composite ");
+        PrintUInt512(Factor, true);
+    }
+    if (Options->Time) { PrintElapsed("test", Start); }
+    return (Factor == 1) ? 0 : 2;
+}
+
+// Prime factors in increasing order, repeated by multiplicity. If Pollard rho
+// runs out of budget the unsplit composite cofactor is printed last and the
+// exit code is 2.
+static int
+CommandFactor(uint512 N, const driver_options* Options)
+{
+    driver_clock::time_point Start = driver_clock::now();
+    if (N <= 1)
+    {
+        PrintUInt512(N, true);
+        return 0;
+    }
+    bool First = true;
+    while (N != 1)
+    {
+        uint512 Factor = PrimalityTestPollardRho(N);
+        if (Factor == 0)
+        {
+            printf(First ? "" : " ");
+            PrintUInt512(N, true);
+            fprintf(stderr, "factor: last value is composite but Pollard rho found no factor within its budget\n");
+            if (Options->Time) { PrintElapsed("factor", Start); }
+            return 2;
+        }
+        if (Factor == 1) { Factor = N; }
+        do
+        {
+            printf(First ? "" : " ");
+            PrintUInt512(Factor);
+            First = false;
+            N /= Factor;
+        } while (N % Factor == 0);
+    }
+    printf("\n");
+    if (Options->Time) { PrintElapsed("factor", Start); }
+    return 0;
+}
+
+// The old Windows test: a random 512-bit prime, then Baillie-PSW on it again.
+static int
+CommandDefault(const driver_options* Options)
+{
+    RandomSeedThread(Options->Seed);
+
+    driver_clock::time_point Start = driver_clock::now();
+    uint512 N = RandomPrime(512);
+    printf("N = ");
+    PrintUInt512(N, true);
+    PrintElapsed("PrimeSearch", Start);
+
+    Start = driver_clock::now();
+    uint512 Factor = PrimalityTestBPSW(N);
+    if (Factor == 1) { printf("Prime? YES\n"); }
+    else
+    {
+        printf("Prime? NO: ");
+        PrintUInt512(Factor, true);
+    }
+    PrintElapsed("PrimeTest", Start);
+    return 0;
+}
+
+static void
+PrintUsage(const char* Program)
+{
+    fprintf(stderr,
+            "usage: %s [command] [options]\n"
+            "  prime BITS        random probable prime of exactly BITS bits (2-512)\n"
+            "  next N            smallest probable prime >= N\n"
+            "  test N            Baillie-PSW; prints prime or composite (with a factor if trial division found one)\n"
+            "  factor N          prime factorization (trial division, then Pollard rho; factors\n"
+            "                    past ~15 digits may be left unsplit)\n"
+            "  (none)            random 512-bit prime search and re-test, timed\n"
+            "N is decimal or 0x-prefixed hex, below 2^512.\n"
+            "  --seed S          seed for prime and the default run (default: from the clock)\n"
+            "  --threads T       worker threads for prime and next (default: all)\n"
+            "  --time            print elapsed time to stderr\n",
+            Program);
+}
+
+int main(int ArgCount, char* ArgValues[])
+{
+    driver_options Options = {};
+    const char* Positional[2] = {};
+    int PositionalCount = 0;
+    for (int ArgIndex = 1; ArgIndex < ArgCount; ++ArgIndex)
+    {
+        const char* Arg = ArgValues[ArgIndex];
+        bool HasValue = ArgIndex + 1 < ArgCount;
+        if (strcmp(Arg, "--seed") == 0 && HasValue)
+        {
+            Options.Seed = strtoull(ArgValues[++ArgIndex], 0, 0);
+            Options.Seeded = true;
+        }
+        else if (strcmp(Arg, "--threads") == 0 && HasValue) { Options.ThreadCount = (uint32_t)atoi(ArgValues[++ArgIndex]); }
+        else if (strcmp(Arg, "--time") == 0) { Options.Time = true; }
+        else if (Arg[0] != '-' && PositionalCount < 2) { Positional[PositionalCount++] = Arg; }
+        else
+        {
+            PrintUsage(ArgValues[0]);
+            return (strcmp(Arg, "--help") == 0) ? 0 : 1;
+        }
+    }
+    if (!Options.Seeded)
+    {
+        Options.Seed = (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    }
+
+    if (PositionalCount == 0) { return CommandDefault(&Options); }
+
+    const char* Command = Positional[0];
+    if (PositionalCount == 2 && strcmp(Command, "prime") == 0)
+    {
+        return CommandPrime((uint32_t)atoi(Positional[1]), &Options);
+    }
+
+    uint512 N;
+    if (PositionalCount == 2 && ParseUInt512(Positional[1], &N))
+    {
+        if (strcmp(Command, "next") == 0) { return CommandNext(N, &Options); }
+        if (strcmp(Command, "test") == 0) { return CommandTest(N, &Options); }
+        if (strcmp(Command, "factor") == 0) { return CommandFactor(N, &Options); }
+    }
+    PrintUsage(ArgValues[0]);
+    return 1;
+}
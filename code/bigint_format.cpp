@@ -0,0 +1,174 @@
+#if !defined(BIGINT_FORMAT_CPP)
+#include "bigint.cpp"
+
+// TEXT CONVERSION:
+// Decimal output peels 19-digit chunks off the number with divisions by 10^19,
+// the largest power of ten in one part. Each chunk is a single pass of
+// multiply-based divisions over the parts still in use (10^19 already has its
+// top bit set, so the reciprocal needs no normalizing shift), and the chunks
+// are then written two digits at a time from a table. Parsing runs the other
+// way: up to 19 digits are gathered in a plain uint64_t and folded into the
+// number with one multiply-add pass per chunk.
+
+// Characters needed for the digits (no terminator) of any Bits-bit number.
+// 1233 / 4096 is just above log10(2).
+#define UINTN_DECIMAL_DIGITS(Bits) ((Bits) * 1233 / 4096 + 1)
+#define UINTN_HEX_DIGITS(Bits) ((Bits) / 4)
+
+static const char DecimalDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char HexDigits[] = "0123456789abcdef";
+
+static const uint64_t PowersOfTen[20] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+    10000000000, 100000000000, 1000000000000, 10000000000000, 100000000000000,
+    1000000000000000, 10000000000000000, 100000000000000000, 1000000000000000000,
+    10000000000000000000u,
+};
+
+// 10^19 prepared for DivideWidePreinverted, at compile time.
+static constexpr part_divisor TenToTheNineteen = MakePartDivisor(10000000000000000000u);
+
+// Writes the low DigitCount decimal digits of Value, zero padded, ending just
+// before End.
+static void
+WriteDecimalDigits(char* End, uint64_t Value, uint32_t DigitCount)
+{
+    for (; DigitCount >= 2; DigitCount -= 2)
+    {
+        uint64_t Pair = Value % 100;
+        Value /= 100;
+        End -= 2;
+        End[0] = DecimalDigitPairs[2 * Pair];
+        End[1] = DecimalDigitPairs[2 * Pair + 1];
+    }
+    if (DigitCount) { *--End = (char)('0' + Value % 10); }
+}
+
+// Writes N in decimal to Buffer, NUL terminated, and returns the number of
+// digits. Returns 0 and writes nothing if BufferSize cannot hold them; a size
+// of UINTN_DECIMAL_DIGITS(Bits) + 1 is always enough.
+template <uint32_t Bits>
+static uint32_t
+UIntFormatDecimal(uintn<Bits> N, char* Buffer, uint32_t BufferSize)
+{
+    uint64_t Chunks[UINTN_DECIMAL_DIGITS(Bits) / 19 + 1];
+    uint32_t ChunkCount = 0;
+    int32_t ActiveCount = SignificantPartCount(N);
+    do
+    {
+        uint64_t Remainder = 0;
+        for (int32_t PartIndex = ActiveCount - 1; PartIndex >= 0; --PartIndex)
+        {
+            N.Parts[PartIndex] = DivideWidePreinverted(Remainder, N.Parts[PartIndex], &TenToTheNineteen, &Remainder);
+        }
+        Chunks[ChunkCount++] = Remainder;
+        while (ActiveCount > 0 && N.Parts[ActiveCount - 1] == 0) { --ActiveCount; }
+    } while (ActiveCount > 0);
+
+    uint64_t Top = Chunks[ChunkCount - 1];
+    uint32_t TopDigits = 1;
+    while (TopDigits < 19 && Top >= PowersOfTen[TopDigits]) { ++TopDigits; }
+    uint32_t Length = TopDigits + 19 * (ChunkCount - 1);
+    if (Length + 1 > BufferSize) { return 0; }
+
+    WriteDecimalDigits(Buffer + TopDigits, Top, TopDigits);
+    for (uint32_t ChunkIndex = 1; ChunkIndex < ChunkCount; ++ChunkIndex)
+    {
+        WriteDecimalDigits(Buffer + TopDigits + 19 * ChunkIndex, Chunks[ChunkCount - 1 - ChunkIndex], 19);
+    }
+    Buffer[Length] = 0;
+    return Length;
+}
+
+// Writes N in lowercase hex without a prefix or leading zeros, NUL terminated,
+// and returns the number of digits (0 if BufferSize is too small).
+template <uint32_t Bits>
+static uint32_t
+UIntFormatHex(uintn<Bits> N, char* Buffer, uint32_t BufferSize)
+{
+    uint32_t BitCount = SignificantBitCount(N);
+    uint32_t Length = (BitCount == 0) ? 1 : (BitCount + 3) / 4;
+    if (Length + 1 > BufferSize) { return 0; }
+    char* End = Buffer + Length;
+    *End = 0;
+    for (int32_t PartIndex = 0; End > Buffer; ++PartIndex)
+    {
+        uint64_t Part = N.Parts[PartIndex];
+        for (int32_t Nibble = 0; Nibble < 16 && End > Buffer; ++Nibble, Part >>= 4)
+        {
+            *--End = HexDigits[Part & 15];
+        }
+    }
+    return Length;
+}
+
+// Parses Length decimal digits. Returns false, leaving Result untouched, on an
+// empty string, a non-digit, or a value that does not fit in Bits bits.
+template <uint32_t Bits>
+static bool
+UIntParseDecimal(const char* Text, uint32_t Length, uintn<Bits>* Result)
+{
+    if (Length == 0) { return false; }
+    uintn<Bits> Value = 0;
+    uint32_t ChunkLength = (Length % 19 == 0) ? 19 : Length % 19;
+    for (uint32_t Position = 0; Position < Length; Position += ChunkLength, ChunkLength = 19)
+    {
+        uint64_t Chunk = 0;
+        for (uint32_t Index = 0; Index < ChunkLength; ++Index)
+        {
+            uint32_t Digit = (uint32_t)(Text[Position + Index] - '0');
+            if (Digit > 9) { return false; }
+            Chunk = 10 * Chunk + Digit;
+        }
+        if (UIntMultiplyAddPart(&Value, PowersOfTen[ChunkLength], Chunk) != 0) { return false; }
+    }
+    *Result = Value;
+    return true;
+}
+
+// Parses Length hex digits (either case) with an optional 0x/0X prefix. Leading
+// zeros are fine; returns false on anything else that is not a hex digit or a
+// value that does not fit.
+template <uint32_t Bits>
+static bool
+UIntParseHex(const char* Text, uint32_t Length, uintn<Bits>* Result)
+{
+    if (Length >= 2 && Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+    {
+        Text += 2;
+        Length -= 2;
+    }
+    if (Length == 0) { return false; }
+
+    // Digits past the top part may only be zeros.
+    for (; Length > UINTN_HEX_DIGITS(Bits); ++Text, --Length)
+    {
+        if (*Text != '0') { return false; }
+    }
+
+    uintn<Bits> Value = 0;
+    const char* End = Text + Length;
+    for (int32_t PartIndex = 0; End > Text; ++PartIndex)
+    {
+        const char* Start = (End - Text > 16) ? End - 16 : Text;
+        uint64_t Part = 0;
+        for (const char* Character = Start; Character < End; ++Character)
+        {
+            uint64_t Digit = HexDigitValue(*Character);
+            if (Digit > 15) { return false; }
+            Part = (Part << 4) | Digit;
+        }
+        Value.Parts[PartIndex] = Part;
+        End = Start;
+    }
+    *Result = Value;
+    return true;
+}
+
+#define BIGINT_FORMAT_CPP
+#endif
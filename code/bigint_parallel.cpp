@@ -0,0 +1,300 @@
+#if !defined(BIGINT_PARALLEL_CPP)
+
+// PARALLEL PRIME SEARCH:
+// The candidate space is cut into numbered work items (a block of sieved odd
+// candidates, or one random draw). Each thread owns a contiguous range of item
+// numbers and works through it from the front; a thread that runs dry steals
+// the back half of another thread's range, and only when there is nothing to
+// steal does it claim a fresh chunk from the shared frontier.
+//
+// The result is always the lowest-numbered item that succeeds, not whichever
+// finished first: once an item succeeds, items above it are cancelled, items
+// below it still run. The answer is therefore the same for any thread count
+// and any scheduling, which is what makes seeded runs reproducible.
+//
+// Build with -pthread on gcc/clang.
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "bigint_primality.cpp"
+
+#if !defined(PARALLEL_CHUNK_ITEMS)
+#define PARALLEL_CHUNK_ITEMS 64 // Items claimed from the frontier at a time
+#endif
+
+#if !defined(PARALLEL_PRIME_BLOCK)
+#define PARALLEL_PRIME_BLOCK 128 // Odd candidates per ParallelNextPrime item
+#endif
+
+#if !defined(PARALLEL_BATCH_CHUNK)
+#define PARALLEL_BATCH_CHUNK 32 // Candidates per PrimalityTestBatchParallel claim
+#endif
+
+#define PARALLEL_SEARCH_NONE 0xFFFFFFFFFFFFFFFF
+
+struct parallel_range
+{
+    std::mutex Lock;
+    uint64_t Begin;
+    uint64_t End;
+};
+
+struct parallel_search
+{
+    uint32_t ThreadCount;
+    uint64_t ItemLimit;
+    parallel_range* Ranges;
+    std::atomic<uint64_t> Frontier;
+    std::atomic<uint64_t> BestItem; // Lowest item known to succeed, PARALLEL_SEARCH_NONE if none yet
+    std::mutex BestLock;
+    uint512 BestValue;
+};
+
+static uint32_t
+ParallelDefaultThreadCount()
+{
+    uint32_t Count = std::thread::hardware_concurrency();
+    return (Count == 0) ? 1 : Count;
+}
+
+// Next item for thread Self, or false when every item below the current best
+// has been handed out.
+static bool
+ParallelClaimItem(parallel_search* Search, uint32_t Self, uint64_t* Item)
+{
+    parallel_range* Own = Search->Ranges + Self;
+    {
+        std::lock_guard<std::mutex> Guard(Own->Lock);
+        if (Own->Begin < Own->End && Own->Begin < Search->BestItem.load())
+        {
+            *Item = Own->Begin++;
+            return true;
+        }
+        Own->Begin = Own->End = 0;
+    }
+
+    // Steal the back half of the first victim with work left below the best.
+    for (uint32_t Offset = 1; Offset < Search->ThreadCount; ++Offset)
+    {
+        parallel_range* Victim = Search->Ranges + (Self + Offset) % Search->ThreadCount;
+        uint64_t StolenBegin, StolenEnd;
+        {
+            std::lock_guard<std::mutex> Guard(Victim->Lock);
+            uint64_t Best = Search->BestItem.load();
+            uint64_t End = (Victim->End < Best) ? Victim->End : Best;
+            if (Victim->Begin >= End) { continue; }
+            StolenBegin = Victim->Begin + (End - Victim->Begin) / 2;
+            StolenEnd = End;
+            Victim->End = StolenBegin;
+        }
+        *Item = StolenBegin;
+        std::lock_guard<std::mutex> Guard(Own->Lock);
+        Own->Begin = StolenBegin + 1;
+        Own->End = StolenEnd;
+        return true;
+    }
+
+    uint64_t ChunkBegin = Search->Frontier.fetch_add(PARALLEL_CHUNK_ITEMS);
+    uint64_t ChunkEnd = ChunkBegin + PARALLEL_CHUNK_ITEMS;
+    if (ChunkBegin >= Search->ItemLimit || ChunkBegin >= Search->BestItem.load()) { return false; }
+    if (ChunkEnd > Search->ItemLimit || ChunkEnd < ChunkBegin) { ChunkEnd = Search->ItemLimit; }
+
+    *Item = ChunkBegin;
+    std::lock_guard<std::mutex> Guard(Own->Lock);
+    Own->Begin = ChunkBegin + 1;
+    Own->End = ChunkEnd;
+    return true;
+}
+
+template <typename test_item>
+static void
+ParallelSearchWorker(parallel_search* Search, uint32_t Self, test_item* TestItem)
+{
+    uint64_t Item;
+    while (ParallelClaimItem(Search, Self, &Item))
+    {
+        uint512 Value;
+        if (!(*TestItem)(Item, &Value)) { continue; }
+
+        std::lock_guard<std::mutex> Guard(Search->BestLock);
+        if (Item < Search->BestItem.load())
+        {
+            Search->BestValue = Value;
+            Search->BestItem.store(Item);
+        }
+    }
+}
+
+// Runs TestItem(Item, &Value) over items 0 .. ItemLimit - 1 on ThreadCount
+// threads (0 = one per hardware thread; the caller's thread is one of them).
+// TestItem must be safe to call concurrently. Returns the lowest item for which
+// it returned true and stores its Value in Found, or PARALLEL_SEARCH_NONE.
+template <typename test_item>
+static uint64_t
+ParallelSearch(uint32_t ThreadCount, uint64_t ItemLimit, test_item TestItem, uint512* Found)
+{
+    if (ThreadCount == 0) { ThreadCount = ParallelDefaultThreadCount(); }
+
+    parallel_search Search;
+    Search.ThreadCount = ThreadCount;
+    Search.ItemLimit = ItemLimit;
+    Search.Ranges = new parallel_range[ThreadCount];
+    Search.Frontier.store(0);
+    Search.BestItem.store(PARALLEL_SEARCH_NONE);
+    for (uint32_t ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        Search.Ranges[ThreadIndex].Begin = Search.Ranges[ThreadIndex].End = 0;
+    }
+
+    std::thread* Threads = new std::thread[ThreadCount - 1];
+    for (uint32_t ThreadIndex = 1; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        Threads[ThreadIndex - 1] = std::thread(ParallelSearchWorker<test_item>, &Search, ThreadIndex, &TestItem);
+    }
+    ParallelSearchWorker(&Search, 0, &TestItem);
+    for (uint32_t ThreadIndex = 1; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        Threads[ThreadIndex - 1].join();
+    }
+    delete[] Threads;
+    delete[] Search.Ranges;
+
+    uint64_t Best = Search.BestItem.load();
+    if (Best != PARALLEL_SEARCH_NONE) { *Found = Search.BestValue; }
+    return Best;
+}
+
+// Per-thread scratch for the block sieve's residues: allocated on a thread's
+// first block, grown if the table is resized, freed when the thread exits.
+struct parallel_residue_buffer
+{
+    uint32_t* Residues;
+    uint32_t Capacity;
+
+    ~parallel_residue_buffer() { free(Residues); }
+};
+
+// Room for Count residues, or null if it cannot be allocated.
+static uint32_t*
+ParallelResidueBuffer(uint32_t Count)
+{
+    static thread_local parallel_residue_buffer Buffer = {};
+    if (Buffer.Capacity < Count)
+    {
+        uint32_t* Grown = (uint32_t*)realloc(Buffer.Residues, Count * sizeof(uint32_t));
+        if (!Grown) { return 0; }
+        Buffer.Residues = Grown;
+        Buffer.Capacity = Count;
+    }
+    return Buffer.Residues;
+}
+
+// Same result as NextPrime(N), with blocks of PARALLEL_PRIME_BLOCK candidates
+// sieved and tested independently on ThreadCount threads.
+static uint512
+ParallelNextPrime(uint512 N, uint32_t ThreadCount = 0)
+{
+    if (N < SmallPrimeTrialLimit()) { return NextPrime(N); }
+    if ((N.Parts[0] & 1) == 0) { N += 1; }
+
+    // Blocks that start below 2^512.
+    uint64_t BlockSpan = 2 * PARALLEL_PRIME_BLOCK;
+    uint64_t Remainder;
+    uint512 BlockCount = UIntDivideByPart(-N, BlockSpan, &Remainder);
+    if (Remainder != 0) { BlockCount += 1; }
+    uint64_t ItemLimit = (SignificantPartCount(BlockCount) > 1) ? PARALLEL_SEARCH_NONE : BlockCount.Parts[0];
+
+    auto TestBlock = [N, BlockSpan](uint64_t Item, uint512* Value) -> bool
+    {
+        uint512 Start = N + uint512(Item) * uint512(BlockSpan);
+        // Without room for the residues every candidate goes to Baillie-PSW,
+        // which gives the same answer, only slower.
+        uint8_t Sieve[PARALLEL_PRIME_BLOCK] = {};
+        uint32_t* Residues = ParallelResidueBuffer(SmallPrimes()->PrimeCount);
+        if (Residues)
+        {
+            SmallPrimeResidues(Start, Residues);
+            SieveOddCandidates(Sieve, PARALLEL_PRIME_BLOCK, Residues);
+        }
+
+        for (uint32_t I = 0; I < PARALLEL_PRIME_BLOCK; ++I)
+        {
+            if (Sieve[I]) { continue; }
+            uint512 Candidate;
+            if (UIntAdd(&Candidate, Start, uint512(2 * (uint64_t)I))) { return false; }
+            if (IsProbablePrimeBPSW(Candidate))
+            {
+                *Value = Candidate;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    uint512 Result = 0;
+    ParallelSearch(ThreadCount, ItemLimit, TestBlock, &Result);
+    return Result;
+}
+
+// Random probable prime of exactly Bits bits (top bit set), 2 <= Bits <= 512.
+// Draw number K is block K of a ChaCha20 stream keyed by Seed, so a given Seed
+// returns the same prime for every thread count.
+static uint512
+ParallelRandomPrime(uint32_t Bits, uint64_t Seed, uint32_t ThreadCount = 0)
+{
+    assert(Bits >= 2 && Bits <= 512);
+    random_chacha20 Keyed;
+    ChaChaSeed(&Keyed, Seed, 0);
+    auto TestDraw = [Bits, &Keyed](uint64_t Item, uint512* Value) -> bool
+    {
+        random_chacha20 Generator = Keyed;
+        ChaChaSeek(&Generator, Item);
+        uint512 Candidate = RandomUIntWithBits<512>(&Generator, Bits);
+        Candidate.Parts[0] |= 1;
+
+        if (PrimalityTestBPSW(Candidate) != 1) { return false; }
+        *Value = Candidate;
+        return true;
+    };
+
+    uint512 Result = 0;
+    ParallelSearch(ThreadCount, PARALLEL_SEARCH_NONE, TestDraw, &Result);
+    return Result;
+}
+
+// PrimalityTestBatch split across ThreadCount threads (0 = one per hardware
+// thread). Threads claim chunks of PARALLEL_BATCH_CHUNK candidates from a shared
+// counter, so a chunk full of primes does not hold up the rest.
+static void
+PrimalityTestBatchParallel(const uint512* Candidates, uint512* Results, uint32_t Count, uint32_t ThreadCount = 0)
+{
+    if (ThreadCount == 0) { ThreadCount = ParallelDefaultThreadCount(); }
+    uint32_t ChunkCount = (Count + PARALLEL_BATCH_CHUNK - 1) / PARALLEL_BATCH_CHUNK;
+    if (ThreadCount > ChunkCount) { ThreadCount = (ChunkCount == 0) ? 1 : ChunkCount; }
+
+    std::atomic<uint32_t> NextChunk(0);
+    auto Worker = [&]()
+    {
+        for (uint32_t Chunk = NextChunk.fetch_add(1); Chunk < ChunkCount; Chunk = NextChunk.fetch_add(1))
+        {
+            uint32_t First = Chunk * PARALLEL_BATCH_CHUNK;
+            uint32_t ChunkSize = (Count - First < PARALLEL_BATCH_CHUNK) ? Count - First : PARALLEL_BATCH_CHUNK;
+            PrimalityTestBatch(Candidates + First, Results + First, ChunkSize);
+        }
+    };
+
+    std::thread* Threads = new std::thread[ThreadCount - 1];
+    for (uint32_t ThreadIndex = 1; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        Threads[ThreadIndex - 1] = std::thread(Worker);
+    }
+    Worker();
+    for (uint32_t ThreadIndex = 1; ThreadIndex < ThreadCount; ++ThreadIndex)
+    {
+        Threads[ThreadIndex - 1].join();
+    }
+    delete[] Threads;
+}
+
+#define BIGINT_PARALLEL_CPP
+#endif
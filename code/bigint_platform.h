@@ -0,0 +1,207 @@
+#if !defined(BIGINT_PLATFORM_H)
+// PLATFORM LAYER:
+// Everything in the library that depends on the compiler lives here: the
+// single-limb carry, multiply and divide primitives, the bit scans, and the
+// unroll / constant-evaluation switches. Each primitive maps straight onto the
+// hardware with either toolchain: unsigned __int128, __builtin_clzll/ctzll and
+// divq on gcc and clang, the _addcarry_u64/_umul128/_udiv128/_BitScan*
+// intrinsics on MSVC x64. Only a compiler with neither gets the portable C.
+// No OS headers are needed; the core builds the same on Windows and Linux.
+#include <stdint.h>
+#include <assert.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define UINTN_GNU 1
+#else
+#define UINTN_GNU 0
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#define UINTN_MSVC_X64 1
+#else
+#define UINTN_MSVC_X64 0
+#endif
+
+#if UINTN_GNU && defined(__x86_64__)
+#define UINTN_GNU_X64 1
+#else
+#define UINTN_GNU_X64 0
+#endif
+
+#if defined(__SIZEOF_INT128__)
+#define UINTN_HAS_INT128 1
+#else
+#define UINTN_HAS_INT128 0
+#endif
+
+// Part loops all have compile-time trip counts; have the compiler unroll them
+// completely for the small widths so each width gets straight-line code.
+#if defined(__clang__)
+#define UINTN_UNROLL _Pragma("unroll 16")
+#elif UINTN_GNU
+#define UINTN_UNROLL _Pragma("GCC unroll 16")
+#else
+#define UINTN_UNROLL
+#endif
+
+// The arithmetic is constexpr so constants (literals, fixed moduli and their
+// Montgomery parameters) can be built at compile time. Intrinsics and inline asm
+// cannot run during constant evaluation, so the primitives that use them fall
+// back to their portable path when UINTN_CONSTANT_EVALUATED() is true.
+#if UINTN_GNU || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define UINTN_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define UINTN_CONSTANT_EVALUATED() false
+#endif
+
+// Single-limb add-with-carry / subtract-with-borrow. These compile down to adc/sbb
+// so a full-width add or subtract is one pass over the limbs.
+constexpr uint8_t
+AddWithCarry(uint8_t CarryIn, uint64_t A, uint64_t B, uint64_t* Result)
+{
+#if UINTN_MSVC_X64
+    if (!UINTN_CONSTANT_EVALUATED()) { return _addcarry_u64(CarryIn, A, B, (unsigned long long*)Result); }
+#endif
+#if UINTN_HAS_INT128
+    unsigned __int128 Sum = (unsigned __int128)A + B + CarryIn;
+    *Result = (uint64_t)Sum;
+    return (uint8_t)(Sum >> 64);
+#else
+    uint64_t Sum = A + B;
+    uint8_t CarryOut = Sum < A;
+    *Result = Sum + CarryIn;
+    return CarryOut | (*Result < Sum);
+#endif
+}
+
+constexpr uint8_t
+SubtractWithBorrow(uint8_t BorrowIn, uint64_t A, uint64_t B, uint64_t* Result)
+{
+#if UINTN_MSVC_X64
+    if (!UINTN_CONSTANT_EVALUATED()) { return _subborrow_u64(BorrowIn, A, B, (unsigned long long*)Result); }
+#endif
+#if UINTN_HAS_INT128
+    unsigned __int128 Difference = (unsigned __int128)A - B - BorrowIn;
+    *Result = (uint64_t)Difference;
+    return (uint8_t)(Difference >> 64) & 1;
+#else
+    uint64_t Difference = A - B;
+    uint8_t BorrowOut = A < B;
+    *Result = Difference - BorrowIn;
+    return BorrowOut | (Difference < BorrowIn);
+#endif
+}
+
+// Full 64x64 -> 128 bit product. Returns the low limb and stores the high one.
+constexpr uint64_t
+MultiplyWithHigh(uint64_t A, uint64_t B, uint64_t* High)
+{
+#if UINTN_MSVC_X64
+    if (!UINTN_CONSTANT_EVALUATED()) { return _umul128(A, B, (unsigned long long*)High); }
+#endif
+#if UINTN_HAS_INT128
+    unsigned __int128 Product = (unsigned __int128)A * B;
+    *High = (uint64_t)(Product >> 64);
+    return (uint64_t)Product;
+#else
+    uint64_t ALow = A & 0xFFFFFFFF, AHigh = A >> 32;
+    uint64_t BLow = B & 0xFFFFFFFF, BHigh = B >> 32;
+    uint64_t LowLow = ALow * BLow;
+    uint64_t HighLow = AHigh * BLow;
+    uint64_t LowHigh = ALow * BHigh;
+    uint64_t Middle = (LowLow >> 32) + (HighLow & 0xFFFFFFFF) + (LowHigh & 0xFFFFFFFF);
+    *High = AHigh * BHigh + (HighLow >> 32) + (LowHigh >> 32) + (Middle >> 32);
+    return (Middle << 32) | (LowLow & 0xFFFFFFFF);
+#endif
+}
+
+// Number of leading zero bits in a non-zero limb.
+constexpr uint32_t
+CountLeadingZeros64(uint64_t A)
+{
+    assert(A != 0);
+#if UINTN_GNU
+    return (uint32_t)__builtin_clzll(A);
+#else
+#if UINTN_MSVC_X64
+    if (!UINTN_CONSTANT_EVALUATED())
+    {
+        unsigned long Index = 0;
+        _BitScanReverse64(&Index, A);
+        return 63 - Index;
+    }
+#endif
+    uint32_t Result = 0;
+    while ((A & 0x8000000000000000) == 0) { A <<= 1; ++Result; }
+    return Result;
+#endif
+}
+
+// Number of trailing zero bits in a non-zero limb.
+constexpr uint32_t
+CountTrailingZeros64(uint64_t A)
+{
+    assert(A != 0);
+#if UINTN_GNU
+    return (uint32_t)__builtin_ctzll(A);
+#else
+#if UINTN_MSVC_X64
+    if (!UINTN_CONSTANT_EVALUATED())
+    {
+        unsigned long Index = 0;
+        _BitScanForward64(&Index, A);
+        return Index;
+    }
+#endif
+    uint32_t Result = 0;
+    while ((A & 1) == 0) { A >>= 1; ++Result; }
+    return Result;
+#endif
+}
+
+#if UINTN_GNU_X64
+// divq on its own, since asm may not appear in a constexpr function before C++20.
+inline uint64_t
+DivideWideX64(uint64_t High, uint64_t Low, uint64_t Divisor, uint64_t* Remainder)
+{
+    uint64_t Quotient;
+    __asm__("divq %4" : "=a"(Quotient), "=d"(*Remainder) : "a"(Low), "d"(High), "rm"(Divisor));
+    return Quotient;
+}
+#endif
+
+// Divides the 128-bit value High:Low by Divisor. High must be less than Divisor
+// so the quotient fits in one limb; this maps directly onto the hardware divide.
+constexpr uint64_t
+DivideWide(uint64_t High, uint64_t Low, uint64_t Divisor, uint64_t* Remainder)
+{
+    assert(High < Divisor);
+#if UINTN_MSVC_X64
+    if (!UINTN_CONSTANT_EVALUATED()) { return _udiv128(High, Low, Divisor, (unsigned long long*)Remainder); }
+#elif UINTN_GNU_X64
+    if (!UINTN_CONSTANT_EVALUATED()) { return DivideWideX64(High, Low, Divisor, Remainder); }
+#endif
+#if UINTN_HAS_INT128
+    unsigned __int128 Dividend = ((unsigned __int128)High << 64) | Low;
+    *Remainder = (uint64_t)(Dividend % Divisor);
+    return (uint64_t)(Dividend / Divisor);
+#else
+    uint64_t Quotient = 0;
+    for (int32_t Bit = 63; Bit >= 0; --Bit)
+    {
+        uint64_t TopBit = High >> 63;
+        High = (High << 1) | (Low >> 63);
+        Low <<= 1;
+        Quotient <<= 1;
+        if (TopBit || High >= Divisor) { High -= Divisor; Quotient |= 1; }
+    }
+    *Remainder = High;
+    return Quotient;
+#endif
+}
+
+#define BIGINT_PLATFORM_H
+#endif
@@ -0,0 +1,694 @@
+#if !defined(BIGINT_PRIMALITY_CPP)
+#include <stdlib.h>
+#include <atomic>
+#include "bigint.cpp"
+#include "bigint_random.cpp"
+
+// Random parts from the calling thread's default generator.
+static uint512
+Random512(uint32_t PartCount)
+{
+    return RandomUInt<512>(ThreadRandom(), PartCount);
+}
+
+static uint32_t
+LogBase2(uint512 N)
+{
+    assert(N != 0);
+    return SignificantBitCount(N) - 1;
+}
+
+static uint512
+TwoPowN(uint32_t N)
+{
+    uint512 Result = 0;
+    if (N < 512) { Result.Parts[N / 64] = (uint64_t)1 << (N % 64); }
+    return Result;
+}
+
+// PRIMALITY TESTS:
+// If prime: returns 1;
+// If not prime: returns smallest prime factor
+// If not a number that can be prime: returns 0
+// The probabilistic tests can prove a number composite without finding any
+// factor; they return 0 for those too.
+
+// Trial division runs over every odd prime up to the table limit. Primes are
+// packed into groups whose product fits in one part, so N is reduced once per
+// group (a reciprocal-based pass, no hardware divides) and each prime is then
+// checked against the 64-bit residue with a multiply and a compare.
+#if !defined(SMALL_PRIME_DEFAULT_LIMIT)
+#define SMALL_PRIME_DEFAULT_LIMIT 3571
+#endif
+
+struct small_prime
+{
+    uint64_t Prime;
+    uint64_t Inverse;      // Prime^-1 mod 2^64
+    uint64_t MaxQuotient;  // (2^64 - 1) / Prime: R is a multiple of Prime iff R * Inverse <= MaxQuotient
+};
+
+struct small_prime_group
+{
+    part_divisor Product;
+    uint32_t FirstPrime;
+    uint32_t PrimeCount;
+};
+
+struct small_prime_table
+{
+    uint32_t Limit;
+    uint32_t PrimeCount;
+    uint32_t GroupCount;
+    small_prime* Primes;
+    small_prime_group* Groups;
+};
+
+// Builds the trial division table with every odd prime up to Limit.
+static small_prime_table
+SmallPrimeTableBuild(uint32_t Limit)
+{
+    assert(Limit >= 3 && Limit < 0xFFFFFFFF);
+
+    // Sieve of Eratosthenes over [0, Limit]
+    uint8_t* Composite = (uint8_t*)calloc(Limit + 1, 1);
+    uint32_t PrimeCount = 0;
+    for (uint64_t Candidate = 3; Candidate <= Limit; Candidate += 2)
+    {
+        if (Composite[Candidate]) { continue; }
+        ++PrimeCount;
+        for (uint64_t Multiple = Candidate * Candidate; Multiple <= Limit; Multiple += 2 * Candidate)
+        {
+            Composite[Multiple] = 1;
+        }
+    }
+
+    small_prime* Primes = (small_prime*)malloc(PrimeCount * sizeof(small_prime));
+    small_prime_group* Groups = (small_prime_group*)malloc(PrimeCount * sizeof(small_prime_group));
+    uint32_t PrimeIndex = 0;
+    uint32_t GroupCount = 0;
+    uint64_t GroupProduct = 1;
+    for (uint64_t Candidate = 3; Candidate <= Limit; Candidate += 2)
+    {
+        if (Composite[Candidate]) { continue; }
+
+        small_prime* Prime = Primes + PrimeIndex;
+        Prime->Prime = Candidate;
+        Prime->Inverse = Candidate;
+        for (int Step = 0; Step < 5; ++Step) { Prime->Inverse *= 2 - Candidate * Prime->Inverse; }
+        Prime->MaxQuotient = 0xFFFFFFFFFFFFFFFF / Candidate;
+
+        if (GroupCount == 0 || GroupProduct > 0xFFFFFFFFFFFFFFFF / Candidate)
+        {
+            if (GroupCount > 0) { Groups[GroupCount - 1].Product = MakePartDivisor(GroupProduct); }
+            Groups[GroupCount].FirstPrime = PrimeIndex;
+            Groups[GroupCount].PrimeCount = 0;
+            ++GroupCount;
+            GroupProduct = 1;
+        }
+        GroupProduct *= Candidate;
+        ++Groups[GroupCount - 1].PrimeCount;
+        ++PrimeIndex;
+    }
+    Groups[GroupCount - 1].Product = MakePartDivisor(GroupProduct);
+    free(Composite);
+
+    small_prime_table Result = { Limit, PrimeCount, GroupCount, Primes, Groups };
+    return Result;
+}
+
+// Table set by SmallPrimeTableInit; null until then, and the default is used.
+static std::atomic<small_prime_table*> SmallPrimeTableResized(nullptr);
+
+// The table the tests use. The default one is built on first use behind a
+// function-local static, so concurrent first calls build it exactly once and
+// every caller sees it complete.
+static const small_prime_table*
+SmallPrimes()
+{
+    const small_prime_table* Resized = SmallPrimeTableResized.load(std::memory_order_acquire);
+    if (Resized) { return Resized; }
+    static const small_prime_table DefaultTable = SmallPrimeTableBuild(SMALL_PRIME_DEFAULT_LIMIT);
+    return &DefaultTable;
+}
+
+// Replaces the table with one holding every odd prime up to Limit. Only needed
+// to change the size from SMALL_PRIME_DEFAULT_LIMIT. The replaced table is freed,
+// so no other thread may be testing primality while this runs.
+static void
+SmallPrimeTableInit(uint32_t Limit)
+{
+    small_prime_table* Table = (small_prime_table*)malloc(sizeof(small_prime_table));
+    *Table = SmallPrimeTableBuild(Limit);
+    small_prime_table* Previous = SmallPrimeTableResized.exchange(Table, std::memory_order_acq_rel);
+    if (Previous)
+    {
+        free(Previous->Primes);
+        free(Previous->Groups);
+        free(Previous);
+    }
+}
+
+// Everything below this with no factor in the table (or 2) is prime.
+static uint64_t
+SmallPrimeTrialLimit()
+{
+    const small_prime_table* Table = SmallPrimes();
+    return (uint64_t)Table->Limit * Table->Limit;
+}
+
+static uint512
+PrimalityTestEarlyOut(uint512 N)
+{
+    const small_prime_table* Table = SmallPrimes();
+    if (BigPartEqualsZero(N)) 
+    {
+        if (N.Parts[0] <= 1) { return 0; }
+        else if (N.Parts[0] <= 3) { return 1; }
+    }
+    if ((N.Parts[0] & 1) == 0) { return 2; }
+    for (uint32_t GroupIndex = 0; GroupIndex < Table->GroupCount; ++GroupIndex)
+    {
+        const small_prime_group* Group = Table->Groups + GroupIndex;
+        uint64_t Residue = UIntRemainderByPart(N, &Group->Product);
+        const small_prime* Prime = Table->Primes + Group->FirstPrime;
+        for (uint32_t PrimeIndex = 0; PrimeIndex < Group->PrimeCount; ++PrimeIndex, ++Prime)
+        {
+            if (Residue * Prime->Inverse <= Prime->MaxQuotient)
+            {
+                return (N == Prime->Prime) ? 1 : Prime->Prime;
+            }
+        }
+    }
+    return 1;
+}
+
+// Splits a non-zero N into D * 2^S with D odd.
+static void
+SplitOffPowerOfTwo(uint512 N, uint512* D, uint32_t* S)
+{
+    *S = TrailingZeroBitCount(N);
+    *D = N >> *S;
+}
+
+// Strong probable-prime test (one Miller-Rabin round) of the modulus of Context
+// to the given Base, which must already be in Montgomery form. NMinusOneOdd
+// and TwoPower are the split of N - 1 from SplitOffPowerOfTwo. Everything
+// stays in Montgomery form; 1 and -1 are compared there directly.
+static bool
+IsStrongProbablePrime(const montgomery512* Context, uint512 Base, uint512 NMinusOneOdd, uint32_t TwoPower)
+{
+    uint512 MinusOne = Context->Modulus - Context->One;
+    uint512 X = MontgomeryPower(Context, Base, NMinusOneOdd);
+    if (X == Context->One || X == MinusOne) { return true; }
+    for (uint32_t Round = 1; Round < TwoPower; ++Round)
+    {
+        X = MontgomerySquare(Context, X);
+        if (X == MinusOne) { return true; }
+        if (X == Context->One) { return false; } // Non-trivial square root of 1
+    }
+    return false;
+}
+
+// Strong base-2 test, the first half of Baillie-PSW. Uses the shift-only power of two.
+static bool
+IsStrongProbablePrimeBase2(const montgomery512* Context, uint512 NMinusOneOdd, uint32_t TwoPower)
+{
+    uint512 MinusOne = Context->Modulus - Context->One;
+    uint512 X = MontgomeryPowerOfTwo(Context, NMinusOneOdd);
+    if (X == Context->One || X == MinusOne) { return true; }
+    for (uint32_t Round = 1; Round < TwoPower; ++Round)
+    {
+        X = MontgomerySquare(Context, X);
+        if (X == MinusOne) { return true; }
+        if (X == Context->One) { return false; }
+    }
+    return false;
+}
+
+// Miller-Rabin with k rounds to random bases in [2, N - 2] drawn from
+// Generator. A composite survives each round with probability at most 1/4.
+template <typename generator>
+static uint512
+PrimalityTestRandom(uint512 N, uint32_t k, generator* Generator)
+{
+    // Early out
+    uint512 EarlyOutResult = PrimalityTestEarlyOut(N);
+    if (EarlyOutResult != 1) { return EarlyOutResult; }
+    if (N < SmallPrimeTrialLimit()) { return 1; }
+
+    montgomery512 Context;
+    MontgomeryInit(&Context, N);
+    uint512 D;
+    uint32_t S;
+    SplitOffPowerOfTwo(N - 1, &D, &S);
+
+    uint512 BaseRange = N - 3;
+    for (uint32_t i = 0; i < k; ++i)
+    {
+        uint512 Base = RandomUInt<512>(Generator) % BaseRange + 2;
+        if (!IsStrongProbablePrime(&Context, ToMontgomery(&Context, Base), D, S)) { return 0; }
+    }
+    return 1;
+}
+
+static uint512
+PrimalityTestRandom(uint512 N, uint32_t k)
+{
+    return PrimalityTestRandom(N, k, ThreadRandom());
+}
+
+// Jacobi symbol (A / M) for odd M.
+static int
+JacobiSymbol64(uint64_t A, uint64_t M)
+{
+    assert((M & 1) == 1);
+    int Result = 1;
+    A %= M;
+    while (A != 0)
+    {
+        while ((A & 1) == 0)
+        {
+            A >>= 1;
+            // (2 / M) is -1 exactly when M is 3 or 5 mod 8.
+            if ((M & 7) == 3 || (M & 7) == 5) { Result = -Result; }
+        }
+        // Quadratic reciprocity: the sign flips when both are 3 mod 4.
+        uint64_t Swap = A; A = M; M = Swap;
+        if ((A & 3) == 3 && (M & 3) == 3) { Result = -Result; }
+        A %= M;
+    }
+    return (M == 1) ? Result : 0;
+}
+
+// Jacobi symbol (D / N) for a small odd D of either sign and a big odd N.
+static int
+JacobiSymbol(int64_t D, uint512 N)
+{
+    uint64_t Magnitude = (D < 0) ? (uint64_t)-D : (uint64_t)D;
+    uint64_t NModMagnitude;
+    UIntDivideByPart(N, Magnitude, &NModMagnitude);
+    // (|D| / N) = (N / |D|), flipped when both are 3 mod 4.
+    int Result = JacobiSymbol64(NModMagnitude, Magnitude);
+    if ((Magnitude & 3) == 3 && (N.Parts[0] & 3) == 3) { Result = -Result; }
+    // (-1 / N) is -1 exactly when N is 3 mod 4.
+    if (D < 0 && (N.Parts[0] & 3) == 3) { Result = -Result; }
+    return Result;
+}
+
+// Montgomery form of a small signed value.
+static uint512
+ToMontgomerySmall(const montgomery512* Context, int64_t Value)
+{
+    uint512 Magnitude = ToMontgomery(Context, uint512((uint64_t)((Value < 0) ? -Value : Value)));
+    return (Value < 0) ? MontgomerySubtract(Context, uint512(0), Magnitude) : Magnitude;
+}
+
+// X / 2 mod N. Halving commutes with the Montgomery factor, so this works on either form.
+static uint512
+MontgomeryHalve(const montgomery512* Context, uint512 X)
+{
+    if ((X.Parts[0] & 1) == 0) { return X >> 1; }
+    uint8_t Carry = UIntAdd(&X, X, Context->Modulus);
+    X >>= 1;
+    X.Parts[UINT512_PARTS - 1] |= (uint64_t)Carry << 63;
+    return X;
+}
+
+// Strong Lucas probable-prime test with Selfridge's parameters: the first D in
+// 5, -7, 9, -11, ... with (D / N) == -1, P = 1 and Q = (1 - D) / 4.
+// N must be odd, not a perfect square, and have no small factors.
+static bool
+IsStrongLucasProbablePrime(const montgomery512* Context)
+{
+    uint512 N = Context->Modulus;
+    int64_t D = 5;
+    for (;;)
+    {
+        int Jacobi = JacobiSymbol(D, N);
+        if (Jacobi == -1) { break; }
+        if (Jacobi == 0) { return false; } // |D| shares a factor with N
+        D = (D < 0) ? -D + 2 : -(D + 2);
+    }
+    int64_t Q = (1 - D) / 4;
+
+    // N + 1 == Odd * 2^S. N + 1 cannot wrap: 2^512 - 1 is a multiple of 3.
+    uint512 Odd;
+    uint32_t S;
+    SplitOffPowerOfTwo(N + 1, &Odd, &S);
+
+    uint512 MontgomeryD = ToMontgomerySmall(Context, D);
+    uint512 MontgomeryQ = ToMontgomerySmall(Context, Q);
+
+    // Left-to-right ladder for U_k, V_k and Q^k, starting at k = 1 (U = 1, V = P = 1).
+    uint512 U = Context->One;
+    uint512 V = Context->One;
+    uint512 QPower = MontgomeryQ;
+    for (int32_t Bit = (int32_t)SignificantBitCount(Odd) - 2; Bit >= 0; --Bit)
+    {
+        // k -> 2k
+        U = MontgomeryMultiply(Context, U, V);
+        V = MontgomerySubtract(Context, MontgomerySquare(Context, V), MontgomeryAdd(Context, QPower, QPower));
+        QPower = MontgomerySquare(Context, QPower);
+        if (GetBitAt(Odd, Bit))
+        {
+            // k -> k + 1: U' = (P*U + V) / 2, V' = (D*U + P*V) / 2
+            uint512 NextU = MontgomeryHalve(Context, MontgomeryAdd(Context, U, V));
+            V = MontgomeryHalve(Context, MontgomeryAdd(Context, MontgomeryMultiply(Context, MontgomeryD, U), V));
+            U = NextU;
+            QPower = MontgomeryMultiply(Context, QPower, MontgomeryQ);
+        }
+    }
+
+    if (U == 0 || V == 0) { return true; }
+    for (uint32_t Round = 1; Round < S; ++Round)
+    {
+        V = MontgomerySubtract(Context, MontgomerySquare(Context, V), MontgomeryAdd(Context, QPower, QPower));
+        if (V == 0) { return true; }
+        QPower = MontgomerySquare(Context, QPower);
+    }
+    return false;
+}
+
+// Baillie-PSW without the trial division, for candidates that have already been
+// sieved. N must be odd and at least SmallPrimeTrialLimit().
+static bool
+IsProbablePrimeBPSW(uint512 N)
+{
+    montgomery512 Context;
+    MontgomeryInit(&Context, N);
+    uint512 D;
+    uint32_t S;
+    SplitOffPowerOfTwo(N - 1, &D, &S);
+    if (!IsStrongProbablePrimeBase2(&Context, D, S)) { return false; }
+    if (UIntIsPerfectSquare(N)) { return false; }
+    return IsStrongLucasProbablePrime(&Context);
+}
+
+// Baillie-PSW: a strong base-2 test followed by a strong Lucas test. No
+// composite is known to pass both, and it costs about three modular
+// exponentiations, so it is the default verdict.
+static uint512
+PrimalityTestBPSW(uint512 N)
+{
+    uint512 EarlyOutResult = PrimalityTestEarlyOut(N);
+    if (EarlyOutResult != 1) { return EarlyOutResult; }
+    if (N < SmallPrimeTrialLimit()) { return 1; }
+    return IsProbablePrimeBPSW(N) ? 1 : 0;
+}
+
+// FACTORING:
+// Brent's variant of Pollard's rho (Brent, "An improved Monte Carlo
+// factorization algorithm", 1980) iterates X -> X^2 + C in Montgomery form and
+// multiplies POLLARD_RHO_BATCH differences |X - Y| together before taking one
+// GCD with N. Montgomery form does not change the GCD: R is a power of two and
+// N is odd. Expected work grows with the square root of the smallest prime
+// factor, about 2^(d/2) steps for a d-bit factor, so a balanced 512-bit
+// semiprime is far out of reach. Each split runs at the narrowest width that
+// holds the number being split.
+//
+// A split gives up after POLLARD_RHO_MAX_STEPS iterations of the map in total,
+// over at most POLLARD_RHO_MAX_INCREMENTS choices of C. The default 2^26 steps
+// is about two seconds at 128 bits and forty at 512, and finds factors up to
+// ~15 digits nearly always. A number that cannot be split within the budget
+// comes back as 0, "composite, no factor found", instead of running forever.
+// Perfect squares are split by their square root first, since rho is no faster
+// on P^2 than on P.
+#if !defined(POLLARD_RHO_BATCH)
+#define POLLARD_RHO_BATCH 128
+#endif
+#if !defined(POLLARD_RHO_MAX_STEPS)
+#define POLLARD_RHO_MAX_STEPS ((uint64_t)1 << 26)
+#endif
+#if !defined(POLLARD_RHO_MAX_INCREMENTS)
+#define POLLARD_RHO_MAX_INCREMENTS 16
+#endif
+
+template <uint32_t Bits>
+inline uintn<Bits>
+AbsoluteDifference(uintn<Bits> A, uintn<Bits> B)
+{
+    return (A >= B) ? A - B : B - A;
+}
+
+// A non-trivial factor of the odd composite modulus of Context, or 0 if this
+// choice of Increment cycled without separating one (retry with another) or
+// *StepBudget ran out. Steps taken are subtracted from *StepBudget.
+template <uint32_t Bits>
+static uintn<Bits>
+PollardRhoBrent(const montgomery_context<Bits>* Context, uintn<Bits> Increment, uint64_t* StepBudget)
+{
+    uintn<Bits> N = Context->Modulus;
+    uintn<Bits> Y = Context->One;
+    uintn<Bits> X = Y;
+    uintn<Bits> SavedY = Y;
+    uintn<Bits> Product = Context->One;
+    uintn<Bits> Divisor = 1;
+    for (uint64_t CycleLength = 1; Divisor == 1; CycleLength *= 2)
+    {
+        // The advance and the batches together take 2 * CycleLength steps.
+        if (*StepBudget < 2 * CycleLength)
+        {
+            *StepBudget = 0;
+            return 0;
+        }
+        *StepBudget -= 2 * CycleLength;
+        X = Y;
+        for (uint64_t Step = 0; Step < CycleLength; ++Step)
+        {
+            Y = MontgomeryAdd(Context, MontgomerySquare(Context, Y), Increment);
+        }
+        for (uint64_t Done = 0; Done < CycleLength && Divisor == 1; Done += POLLARD_RHO_BATCH)
+        {
+            SavedY = Y;
+            uint64_t BatchSize = (CycleLength - Done < POLLARD_RHO_BATCH) ? CycleLength - Done : POLLARD_RHO_BATCH;
+            for (uint64_t Step = 0; Step < BatchSize; ++Step)
+            {
+                Y = MontgomeryAdd(Context, MontgomerySquare(Context, Y), Increment);
+                Product = MontgomeryMultiply(Context, Product, AbsoluteDifference(X, Y));
+            }
+            Divisor = UIntGCD(Product, N);
+        }
+    }
+
+    // The batch overshot and collected every factor at once: replay it one
+    // difference at a time.
+    if (Divisor == N)
+    {
+        do
+        {
+            SavedY = MontgomeryAdd(Context, MontgomerySquare(Context, SavedY), Increment);
+            Divisor = UIntGCD(AbsoluteDifference(X, SavedY), N);
+        } while (Divisor == 1);
+    }
+    return (Divisor == N) ? uintn<Bits>(0) : Divisor;
+}
+
+// A non-trivial factor of the odd composite N, or 0 if none turned up within
+// the step and increment budget.
+template <uint32_t Bits>
+static uint512
+PollardRhoSplit(uint512 N)
+{
+    montgomery_context<Bits> Context;
+    MontgomeryInit(&Context, uintn<Bits>(N.Parts));
+    uintn<Bits> Factor = 0;
+    uint64_t StepBudget = POLLARD_RHO_MAX_STEPS;
+    for (uint64_t Increment = 1; Factor == 0 && StepBudget > 0 && Increment <= POLLARD_RHO_MAX_INCREMENTS; ++Increment)
+    {
+        Factor = PollardRhoBrent(&Context, uintn<Bits>(Increment), &StepBudget);
+    }
+
+    uint512 Result = 0;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { Result.Parts[PartIndex] = Factor.Parts[PartIndex]; }
+    return Result;
+}
+
+// Smallest prime factor of N, which must have no factor in the small prime
+// table. Every composite piece is split until only (probable) primes remain;
+// 0 if some piece could not be split within the rho budget, since the smallest
+// factor may be hiding in it.
+static uint512
+SmallestPrimeFactorRho(uint512 N)
+{
+    if (N < SmallPrimeTrialLimit() || IsProbablePrimeBPSW(N)) { return N; }
+
+    uint512 Factor;
+    if (!UIntIsPerfectSquare(N, &Factor))
+    {
+        int32_t Parts = SignificantPartCount(N);
+        if (Parts <= 2) { Factor = PollardRhoSplit<128>(N); }
+        else if (Parts <= 4) { Factor = PollardRhoSplit<256>(N); }
+        else { Factor = PollardRhoSplit<512>(N); }
+    }
+    if (Factor == 0) { return 0; }
+
+    uint512 Left = SmallestPrimeFactorRho(Factor);
+    uint512 Right = SmallestPrimeFactorRho(N / Factor);
+    if (Left == 0 || Right == 0) { return 0; }
+    return (Left < Right) ? Left : Right;
+}
+
+// Same contract as the other tests, but composites come back with their
+// smallest prime factor: table primes by trial division, anything larger by
+// Pollard rho. Primality of the pieces is decided by Baillie-PSW. A composite
+// rho cannot finish splitting within POLLARD_RHO_MAX_STEPS returns 0, like a
+// Baillie-PSW composite.
+static uint512
+PrimalityTestPollardRho(uint512 N)
+{
+    uint512 EarlyOutResult = PrimalityTestEarlyOut(N);
+    if (EarlyOutResult != 1) { return EarlyOutResult; }
+    uint512 Factor = SmallestPrimeFactorRho(N);
+    return (Factor == N) ? 1 : Factor;
+}
+
+// BATCH PRIMALITY:
+// Results[I] = PrimalityTestBPSW(Candidates[I]) for I < Count, following the
+// PRIMALITY TESTS contract element by element. Trial division runs over the
+// whole span first while the prime table is hot in cache; only the survivors
+// then pay for Baillie-PSW.
+static void
+PrimalityTestBatch(const uint512* Candidates, uint512* Results, uint32_t Count)
+{
+    for (uint32_t Index = 0; Index < Count; ++Index)
+    {
+        Results[Index] = PrimalityTestEarlyOut(Candidates[Index]);
+    }
+    uint64_t TrialLimit = SmallPrimeTrialLimit();
+    for (uint32_t Index = 0; Index < Count; ++Index)
+    {
+        if (Results[Index] != 1 || Candidates[Index] < TrialLimit) { continue; }
+        Results[Index] = IsProbablePrimeBPSW(Candidates[Index]) ? 1 : 0;
+    }
+}
+
+// PRIME GENERATION:
+// Candidates N, N + 2, N + 4, ... are sieved a window at a time against the
+// small prime table. Each prime's residue is computed once up front and then
+// advanced by addition from window to window, so only the survivors pay for
+// a Baillie-PSW test.
+#if !defined(PRIME_SIEVE_WINDOW)
+#define PRIME_SIEVE_WINDOW 2048 // Odd candidates per window
+#endif
+
+// Residue of N modulo every table prime, in table order.
+static void
+SmallPrimeResidues(uint512 N, uint32_t* Residues)
+{
+    const small_prime_table* Table = SmallPrimes();
+    for (uint32_t GroupIndex = 0; GroupIndex < Table->GroupCount; ++GroupIndex)
+    {
+        const small_prime_group* Group = Table->Groups + GroupIndex;
+        uint64_t GroupResidue = UIntRemainderByPart(N, &Group->Product);
+        for (uint32_t PrimeIndex = Group->FirstPrime; PrimeIndex < Group->FirstPrime + Group->PrimeCount; ++PrimeIndex)
+        {
+            Residues[PrimeIndex] = (uint32_t)(GroupResidue % Table->Primes[PrimeIndex].Prime);
+        }
+    }
+}
+
+// Marks Sieve[I] for every candidate Start + 2 * I (I < Count) that has a table
+// prime factor, given Residues = SmallPrimeResidues(Start).
+static void
+SieveOddCandidates(uint8_t* Sieve, uint32_t Count, const uint32_t* Residues)
+{
+    const small_prime_table* Table = SmallPrimes();
+    for (uint32_t PrimeIndex = 0; PrimeIndex < Table->PrimeCount; ++PrimeIndex)
+    {
+        // Candidate I is a multiple of Prime when 2 * I == -Residue (mod Prime),
+        // i.e. I == -Residue * (Prime + 1) / 2.
+        uint64_t Prime = Table->Primes[PrimeIndex].Prime;
+        uint64_t Residue = Residues[PrimeIndex];
+        uint64_t Negated = (Residue == 0) ? 0 : Prime - Residue;
+        for (uint64_t I = (Negated * ((Prime + 1) / 2)) % Prime; I < Count; I += Prime)
+        {
+            Sieve[I] = 1;
+        }
+    }
+}
+
+// Smallest probable prime >= N, or 0 if there is none below 2^512.
+static uint512
+NextPrime(uint512 N)
+{
+    if (N <= 2) { return 2; }
+    if ((N.Parts[0] & 1) == 0) { N += 1; }
+
+    // Below the trial limit the table decides exactly and sieving would strike
+    // out the table primes themselves.
+    while (N < SmallPrimeTrialLimit())
+    {
+        if (PrimalityTestEarlyOut(N) == 1) { return N; }
+        N += 2;
+    }
+
+    const small_prime_table* Table = SmallPrimes();
+    uint32_t PrimeCount = Table->PrimeCount;
+    // Per prime: residue of the window start, and how far a window moves it.
+    uint32_t* Residues = (uint32_t*)malloc(2 * PrimeCount * sizeof(uint32_t));
+    uint32_t* WindowSteps = Residues + PrimeCount;
+    SmallPrimeResidues(N, Residues);
+    for (uint32_t PrimeIndex = 0; PrimeIndex < PrimeCount; ++PrimeIndex)
+    {
+        WindowSteps[PrimeIndex] = (uint32_t)((2 * PRIME_SIEVE_WINDOW) % Table->Primes[PrimeIndex].Prime);
+    }
+
+    uint512 Result = 0;
+    uint512 WindowStart = N;
+    bool Wrapped = false;
+    while (!Wrapped)
+    {
+        uint8_t Sieve[PRIME_SIEVE_WINDOW] = {};
+        SieveOddCandidates(Sieve, PRIME_SIEVE_WINDOW, Residues);
+        for (uint32_t PrimeIndex = 0; PrimeIndex < PrimeCount; ++PrimeIndex)
+        {
+            uint64_t Prime = Table->Primes[PrimeIndex].Prime;
+            uint64_t NextResidue = (uint64_t)Residues[PrimeIndex] + WindowSteps[PrimeIndex];
+            Residues[PrimeIndex] = (uint32_t)((NextResidue >= Prime) ? NextResidue - Prime : NextResidue);
+        }
+
+        for (uint32_t I = 0; I < PRIME_SIEVE_WINDOW; ++I)
+        {
+            if (Sieve[I]) { continue; }
+            uint512 Candidate;
+            if (UIntAdd(&Candidate, WindowStart, uint512(2 * (uint64_t)I))) { Wrapped = true; break; }
+            if (IsProbablePrimeBPSW(Candidate))
+            {
+                Result = Candidate;
+                break;
+            }
+        }
+        if (Result != 0) { break; }
+        Wrapped = Wrapped || UIntAdd(&WindowStart, WindowStart, uint512(2 * (uint64_t)PRIME_SIEVE_WINDOW));
+    }
+
+    free(Residues);
+    return Result;
+}
+
+// Random probable prime of exactly Bits bits (top bit set), 2 <= Bits <= 512,
+// starting from a draw from Generator.
+template <typename generator>
+static uint512
+RandomPrime(uint32_t Bits, generator* Generator)
+{
+    assert(Bits >= 2 && Bits <= 512);
+    for (;;)
+    {
+        uint512 Start = RandomUIntWithBits<512>(Generator, Bits);
+
+        // Retry in the rare case the search runs past the top of the range.
+        uint512 Result = NextPrime(Start);
+        if (Result != 0 && SignificantBitCount(Result) == Bits) { return Result; }
+    }
+}
+
+static uint512
+RandomPrime(uint32_t Bits)
+{
+    return RandomPrime(Bits, ThreadRandom());
+}
+
+#define BIGINT_PRIMALITY_CPP
+#endif
@@ -0,0 +1,278 @@
+#if !defined(BIGINT_RANDOM_CPP)
+#include <atomic>
+#include "bigint.cpp"
+
+// RANDOM NUMBER GENERATORS:
+// Two engines behind the same small set of overloads, so anything that needs
+// random limbs can be written once as a template over the generator:
+//   RandomNext(Generator)                   one 64-bit part
+//   RandomFill(Generator, Parts, Count)     Count parts in bulk
+//
+// random_xoshiro256 is xoshiro256** (Blackman & Vigna): four parts of state, a
+// few cycles per part, not cryptographic. XoshiroJump and XoshiroLongJump skip
+// 2^128 and 2^192 outputs, so a run of jumps hands out non-overlapping streams
+// for threads.
+//
+// random_chacha20 is the ChaCha20 block function (Bernstein) with a 64-bit
+// block counter and a 64-bit stream number. It is slower but unpredictable
+// without the key, and it is counter based: ChaChaSeek jumps straight to any
+// block, and every (key, stream) pair is an independent sequence of 2^64
+// blocks of 512 bits each.
+
+// splitmix64: expands a seed into well-mixed parts for engine state.
+inline uint64_t
+SplitMix64(uint64_t* State)
+{
+    uint64_t X = (*State += 0x9E3779B97F4A7C15);
+    X = (X ^ (X >> 30)) * 0xBF58476D1CE4E5B9;
+    X = (X ^ (X >> 27)) * 0x94D049BB133111EB;
+    return X ^ (X >> 31);
+}
+
+inline uint64_t
+RotateLeft64(uint64_t X, uint32_t Count)
+{
+    return (X << Count) | (X >> (64 - Count));
+}
+
+inline uint32_t
+RotateLeft32(uint32_t X, uint32_t Count)
+{
+    return (X << Count) | (X >> (32 - Count));
+}
+
+struct random_xoshiro256
+{
+    uint64_t State[4];
+};
+
+static void
+XoshiroSeed(random_xoshiro256* Generator, uint64_t Seed)
+{
+    // splitmix64 never yields four zero parts in a row, which is the one state
+    // xoshiro cannot leave.
+    for (int Index = 0; Index < 4; ++Index) { Generator->State[Index] = SplitMix64(&Seed); }
+}
+
+inline uint64_t
+RandomNext(random_xoshiro256* Generator)
+{
+    uint64_t* S = Generator->State;
+    uint64_t Result = RotateLeft64(S[1] * 5, 7) * 9;
+    uint64_t T = S[1] << 17;
+    S[2] ^= S[0];
+    S[3] ^= S[1];
+    S[1] ^= S[2];
+    S[0] ^= S[3];
+    S[2] ^= T;
+    S[3] = RotateLeft64(S[3], 45);
+    return Result;
+}
+
+static void
+RandomFill(random_xoshiro256* Generator, uint64_t* Parts, uint32_t Count)
+{
+    // Keep the state in locals for the loop instead of round-tripping memory.
+    random_xoshiro256 Local = *Generator;
+    for (uint32_t Index = 0; Index < Count; ++Index) { Parts[Index] = RandomNext(&Local); }
+    *Generator = Local;
+}
+
+static void
+XoshiroJumpBy(random_xoshiro256* Generator, const uint64_t Polynomial[4])
+{
+    uint64_t Result[4] = {};
+    for (int Word = 0; Word < 4; ++Word)
+    {
+        for (int Bit = 0; Bit < 64; ++Bit)
+        {
+            if (Polynomial[Word] & ((uint64_t)1 << Bit))
+            {
+                for (int Index = 0; Index < 4; ++Index) { Result[Index] ^= Generator->State[Index]; }
+            }
+            RandomNext(Generator);
+        }
+    }
+    for (int Index = 0; Index < 4; ++Index) { Generator->State[Index] = Result[Index]; }
+}
+
+// Advances by 2^128 outputs.
+static void
+XoshiroJump(random_xoshiro256* Generator)
+{
+    static const uint64_t Jump[4] = { 0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C };
+    XoshiroJumpBy(Generator, Jump);
+}
+
+// Advances by 2^192 outputs.
+static void
+XoshiroLongJump(random_xoshiro256* Generator)
+{
+    static const uint64_t LongJump[4] = { 0x76E15D3EFEFDCBBF, 0xC5004E441C522FB3, 0x77710069854EE241, 0x39109BB02ACBE635 };
+    XoshiroJumpBy(Generator, LongJump);
+}
+
+struct random_chacha20
+{
+    uint32_t Input[16];  // constants, key, block counter, stream
+    uint64_t Buffer[8];  // current block, consumed from BufferUsed up
+    uint32_t BufferUsed;
+};
+
+#define CHACHA_QUARTER_ROUND(A, B, C, D) \
+    A += B; D = RotateLeft32(D ^ A, 16); \
+    C += D; B = RotateLeft32(B ^ C, 12); \
+    A += B; D = RotateLeft32(D ^ A, 8);  \
+    C += D; B = RotateLeft32(B ^ C, 7)
+
+// One 64-byte block for the counter currently in Input, as eight parts.
+static void
+ChaChaBlock(const uint32_t Input[16], uint64_t Output[8])
+{
+    uint32_t X[16];
+    for (int Index = 0; Index < 16; ++Index) { X[Index] = Input[Index]; }
+    for (int Round = 0; Round < 10; ++Round)
+    {
+        CHACHA_QUARTER_ROUND(X[0], X[4], X[8], X[12]);
+        CHACHA_QUARTER_ROUND(X[1], X[5], X[9], X[13]);
+        CHACHA_QUARTER_ROUND(X[2], X[6], X[10], X[14]);
+        CHACHA_QUARTER_ROUND(X[3], X[7], X[11], X[15]);
+        CHACHA_QUARTER_ROUND(X[0], X[5], X[10], X[15]);
+        CHACHA_QUARTER_ROUND(X[1], X[6], X[11], X[12]);
+        CHACHA_QUARTER_ROUND(X[2], X[7], X[8], X[13]);
+        CHACHA_QUARTER_ROUND(X[3], X[4], X[9], X[14]);
+    }
+    for (int Index = 0; Index < 8; ++Index)
+    {
+        Output[Index] = (uint64_t)(X[2 * Index] + Input[2 * Index]) |
+                        (uint64_t)(X[2 * Index + 1] + Input[2 * Index + 1]) << 32;
+    }
+}
+
+// Moves to block BlockIndex of the current stream; the next output is the first
+// part of that block.
+static void
+ChaChaSeek(random_chacha20* Generator, uint64_t BlockIndex)
+{
+    Generator->Input[12] = (uint32_t)BlockIndex;
+    Generator->Input[13] = (uint32_t)(BlockIndex >> 32);
+    Generator->BufferUsed = 8;
+}
+
+static void
+ChaChaSeed(random_chacha20* Generator, const uint64_t Key[4], uint64_t Stream)
+{
+    Generator->Input[0] = 0x61707865;  // "expand 32-byte k"
+    Generator->Input[1] = 0x3320646E;
+    Generator->Input[2] = 0x79622D32;
+    Generator->Input[3] = 0x6B206574;
+    for (int Index = 0; Index < 4; ++Index)
+    {
+        Generator->Input[4 + 2 * Index] = (uint32_t)Key[Index];
+        Generator->Input[5 + 2 * Index] = (uint32_t)(Key[Index] >> 32);
+    }
+    Generator->Input[14] = (uint32_t)Stream;
+    Generator->Input[15] = (uint32_t)(Stream >> 32);
+    ChaChaSeek(Generator, 0);
+}
+
+// Keys the generator from a 64-bit seed. Reproducible, but only as
+// unpredictable as the seed; pass a real 256-bit key to ChaChaSeed for that.
+static void
+ChaChaSeed(random_chacha20* Generator, uint64_t Seed, uint64_t Stream)
+{
+    uint64_t Key[4];
+    for (int Index = 0; Index < 4; ++Index) { Key[Index] = SplitMix64(&Seed); }
+    ChaChaSeed(Generator, Key, Stream);
+}
+
+inline void
+ChaChaNextBlock(random_chacha20* Generator, uint64_t Output[8])
+{
+    ChaChaBlock(Generator->Input, Output);
+    if (++Generator->Input[12] == 0) { ++Generator->Input[13]; }
+}
+
+static void
+RandomFill(random_chacha20* Generator, uint64_t* Parts, uint32_t Count)
+{
+    while (Count > 0 && Generator->BufferUsed < 8)
+    {
+        *Parts++ = Generator->Buffer[Generator->BufferUsed++];
+        --Count;
+    }
+    // Whole blocks go straight to the caller.
+    for (; Count >= 8; Count -= 8, Parts += 8) { ChaChaNextBlock(Generator, Parts); }
+    if (Count > 0)
+    {
+        ChaChaNextBlock(Generator, Generator->Buffer);
+        for (Generator->BufferUsed = 0; Generator->BufferUsed < Count; ++Generator->BufferUsed)
+        {
+            Parts[Generator->BufferUsed] = Generator->Buffer[Generator->BufferUsed];
+        }
+    }
+}
+
+inline uint64_t
+RandomNext(random_chacha20* Generator)
+{
+    if (Generator->BufferUsed == 8)
+    {
+        ChaChaNextBlock(Generator, Generator->Buffer);
+        Generator->BufferUsed = 0;
+    }
+    return Generator->Buffer[Generator->BufferUsed++];
+}
+
+// Random number with its low PartCount parts filled (the rest zero).
+template <uint32_t Bits, typename generator>
+static uintn<Bits>
+RandomUInt(generator* Generator, uint32_t PartCount = uintn<Bits>::PartCount)
+{
+    uintn<Bits> Result = 0;
+    if (PartCount > (uint32_t)uintn<Bits>::PartCount) { PartCount = uintn<Bits>::PartCount; }
+    RandomFill(Generator, Result.Parts, PartCount);
+    return Result;
+}
+
+// Random number of exactly BitCount bits: the top bit set, the bits above it
+// clear.
+template <uint32_t Bits, typename generator>
+static uintn<Bits>
+RandomUIntWithBits(generator* Generator, uint32_t BitCount)
+{
+    assert(BitCount >= 1 && BitCount <= Bits);
+    uint32_t TopPart = (BitCount - 1) / 64;
+    uint32_t TopBit = (BitCount - 1) % 64;
+    uintn<Bits> Result = RandomUInt<Bits>(Generator, TopPart + 1);
+    Result.Parts[TopPart] &= (TopBit == 63) ? 0xFFFFFFFFFFFFFFFF : ((uint64_t)1 << (TopBit + 1)) - 1;
+    Result.Parts[TopPart] |= (uint64_t)1 << TopBit;
+    return Result;
+}
+
+// Default generator for callers that do not bring their own: one xoshiro256**
+// per thread, so there is no shared state to contend on. A thread that never
+// calls RandomSeedThread gets its own stream from a process-wide counter.
+static std::atomic<uint64_t> RandomThreadSeedCounter(0x2545F4914F6CDD1D);
+static thread_local random_xoshiro256 ThreadRandomGenerator;
+static thread_local bool ThreadRandomSeeded = false;
+
+static void
+RandomSeedThread(uint64_t Seed)
+{
+    XoshiroSeed(&ThreadRandomGenerator, Seed);
+    ThreadRandomSeeded = true;
+}
+
+inline random_xoshiro256*
+ThreadRandom()
+{
+    if (!ThreadRandomSeeded)
+    {
+        RandomSeedThread(RandomThreadSeedCounter.fetch_add(0x9E3779B97F4A7C15));
+    }
+    return &ThreadRandomGenerator;
+}
+
+#define BIGINT_RANDOM_CPP
+#endif
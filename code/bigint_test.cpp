@@ -0,0 +1,1244 @@
+// Self-checking tests. Prints one line per group and exits non-zero if any
+// check fails:
+//   ./build.sh test && build/linux/bigint_test [seed]      (build.bat test)
+//
+// Results are checked against an identity or an independent computation where
+// there is one (Q * B + R == A), and against known answers otherwise. Also
+// worth running with CXXFLAGS=-DBIGINT_STATS, which adds checks that the
+// Algorithm D vectors really reach the correction and add-back steps.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bigint.cpp"
+#include "bigint_primality.cpp"
+#include "bigint_parallel.cpp"
+#include "bigint_format.cpp"
+#include "bigint_batch.cpp"
+
+static uint32_t TestCheckCount;
+static uint32_t TestFailureCount;
+static uint32_t TestGroupFailures;
+
+#define TEST_CHECK(Condition) TestCheck((Condition), #Condition, __FILE__, __LINE__)
+
+static bool
+TestCheck(bool Passed, const char* Condition, const char* File, int Line)
+{
+    ++TestCheckCount;
+    if (!Passed)
+    {
+        // Loops repeat the same check many times; a handful of reports is plenty.
+        if (TestGroupFailures < 10) { fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Condition); }
+        ++TestFailureCount;
+        ++TestGroupFailures;
+    }
+    return Passed;
+}
+
+static void
+TestGroupBegin(const char* Name)
+{
+    printf("%-40s", Name);
+    fflush(stdout);
+    TestGroupFailures = 0;
+}
+
+static void
+TestGroupEnd()
+{
+    if (TestGroupFailures) { printf("FAILED (%u)\n", TestGroupFailures); }
+    else { printf("ok\n"); }
+}
+
+// A zero-extended to twice the width, to compare against UIntMultiplyWide.
+template <uint32_t Bits>
+static uintn<2 * Bits>
+Widen(const uintn<Bits>& A)
+{
+    uintn<2 * Bits> Result = 0;
+    for (int32_t PartIndex = 0; PartIndex < uintn<Bits>::PartCount; ++PartIndex) { Result.Parts[PartIndex] = A.Parts[PartIndex]; }
+    return Result;
+}
+
+// Mostly dense random values, but with whole parts of 0, 1 and all ones mixed
+// in: those are where carries, borrows and quotient estimates go wrong.
+template <uint32_t Bits>
+static uintn<Bits>
+TestOperand(random_xoshiro256* Generator)
+{
+    uint32_t PartCount = 1 + (uint32_t)(RandomNext(Generator) % uintn<Bits>::PartCount);
+    uintn<Bits> Result = RandomUInt<Bits>(Generator, PartCount);
+    for (uint32_t PartIndex = 0; PartIndex < PartCount; ++PartIndex)
+    {
+        uint64_t Pick = RandomNext(Generator) % 8;
+        if (Pick == 0) { Result.Parts[PartIndex] = 0; }
+        else if (Pick == 1) { Result.Parts[PartIndex] = 0xFFFFFFFFFFFFFFFF; }
+        else if (Pick == 2) { Result.Parts[PartIndex] = 0x8000000000000000; }
+    }
+    return Result;
+}
+
+static uint512
+TestDecimal(const char* Text)
+{
+    uint512 Result = 0;
+    bool Parsed = UIntParseDecimal(Text, (uint32_t)strlen(Text), &Result);
+    assert(Parsed);
+    (void)Parsed;
+    return Result;
+}
+
+//
+// Multiplication
+//
+
+// Plain schoolbook product, one row per limb of A, as the reference.
+template <uint32_t Bits>
+static uintn<2 * Bits>
+TestMultiplyReference(const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    uintn<2 * Bits> Result = 0;
+    for (int32_t Row = 0; Row < uintn<Bits>::PartCount; ++Row)
+    {
+        uint64_t Carry = 0;
+        for (int32_t Column = 0; Column < uintn<Bits>::PartCount; ++Column)
+        {
+            uint64_t High = 0;
+            uint64_t Low = MultiplyWithHigh(A.Parts[Row], B.Parts[Column], &High);
+            Low += Carry;
+            High += (Low < Carry);
+            Result.Parts[Row + Column] += Low;
+            High += (Result.Parts[Row + Column] < Low);
+            Carry = High;
+        }
+        Result.Parts[Row + uintn<Bits>::PartCount] = Carry;
+    }
+    return Result;
+}
+
+// From 1024 bits (BIGINT_KARATSUBA_THRESHOLD limbs) up the wide, square and
+// truncated products go through Karatsuba; below it through the Comba kernels.
+// Both are checked against the schoolbook product and against each other.
+template <uint32_t Bits>
+static void
+TestMultiply(random_xoshiro256* Generator, uint32_t Count)
+{
+    const int32_t PartCount = uintn<Bits>::PartCount;
+    char Name[64];
+    snprintf(Name, sizeof(Name), "multiply: %u-bit (%s)", Bits,
+             (PartCount >= BIGINT_KARATSUBA_THRESHOLD) ? "karatsuba" : "comba");
+    TestGroupBegin(Name);
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        uintn<Bits> A = (Iteration == 0) ? uintn<Bits>(0) - 1 : TestOperand<Bits>(Generator);
+        uintn<Bits> B = (Iteration == 0) ? uintn<Bits>(0) - 1 : TestOperand<Bits>(Generator);
+        uintn<2 * Bits> Expected = TestMultiplyReference(A, B);
+        uintn<2 * Bits> Wide = UIntMultiplyWide(A, B);
+        TEST_CHECK(Wide == Expected);
+        TEST_CHECK(UIntSquare(A) == TestMultiplyReference(A, A));
+        TEST_CHECK(A * B == uintn<Bits>(Expected.Parts));
+
+        uintn<2 * Bits> Comba;
+        limb_multiply<PartCount, false>::Wide(Comba.Parts, A.Parts, B.Parts);
+        TEST_CHECK(Comba == Wide);
+    }
+    TestGroupEnd();
+}
+
+//
+// Division
+//
+
+template <uint32_t Bits>
+static bool
+CheckDivision(const uintn<Bits>& A, const uintn<Bits>& B)
+{
+    uintn_division_result<Bits> Result = UIntDivision(A, B);
+    bool Passed = TEST_CHECK(Result.Remainder < B);
+    Passed &= TEST_CHECK(UIntMultiplyWide(Result.Quotient, B) + Widen(Result.Remainder) == Widen(A));
+    return Passed;
+}
+
+// Dividends and divisors (most significant part first, as written) that make
+// Algorithm D overshoot its quotient digit and add the divisor back.
+static const uint64_t TestAddBackVectors[][2][4] =
+{
+    { { 0x7FFFFFFFFFFFFFFF, 0x8000000000000000, 0x8000000000000000, 0xFFFFFFFFFFFFFFFE },
+      { 0x0000000000000000, 0x8000000000000000, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF } },
+    { { 0x0000000000000002, 0x0000000000000000, 0x0000000000000002, 0x0000000000000000 },
+      { 0x0000000000000000, 0x8000000000000000, 0x0000000000000000, 0xFFFFFFFFFFFFFFFF } },
+    { { 0x8000000000000000, 0x7FFFFFFFFFFFFFFF, 0x0000000000000001, 0x7FFFFFFFFFFFFFFF },
+      { 0x0000000000000000, 0x8000000000000000, 0x7FFFFFFFFFFFFFFF, 0x7FFFFFFFFFFFFFFF } },
+    { { 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFE, 0x0000000000000001, 0x7FFFFFFFFFFFFFFF },
+      { 0x0000000000000000, 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFF } },
+    { { 0xFFFFFFFFFFFFFFFE, 0x0000000000000002, 0x0000000000000001, 0x0000000000000002 },
+      { 0x0000000000000000, 0x0000000000000002, 0x0000000000000002, 0x0000000000000002 } },
+    { { 0xFFFFFFFFFFFFFFFE, 0x0000000000000000, 0x8000000000000000, 0x8000000000000001 },
+      { 0x0000000000000000, 0x8000000000000000, 0x0000000000000000, 0x7FFFFFFFFFFFFFFF } },
+};
+
+static uint256
+FromMostSignificant(const uint64_t Parts[4])
+{
+    uint256 Result;
+    for (int32_t PartIndex = 0; PartIndex < 4; ++PartIndex) { Result.Parts[PartIndex] = Parts[3 - PartIndex]; }
+    return Result;
+}
+
+static void
+TestDivisionEdgeCases()
+{
+    TestGroupBegin("division: Algorithm D edge cases");
+
+    // Top limbs equal, so the quotient digit estimate saturates at 2^64 - 1,
+    // sometimes then stepped down by the correction loop. Normalized and not.
+    const uint64_t EqualTop[][2][4] =
+    {
+        { { 0x8000000000000000, 3, 2, 1 }, { 0, 0x8000000000000000, 6, 5 } },
+        { { 0xFFFFFFFFFFFFFFFF, 0, 0, 0 }, { 0, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF } },
+        { { 0x8000000000000000, 0, 0, 0 }, { 0, 0x8000000000000000, 0, 1 } },
+        { { 1, 0xFFFFFFFFFFFFFFFF, 0, 0 }, { 0, 1, 0xFFFFFFFFFFFFFFFF, 1 } },
+        { { 0, 0x123456789ABCDEF0, 5, 7 }, { 0, 0, 0x123456789ABCDEF0, 9 } },
+        { { 0xFFFFFFFFFFFFFFFF, 1, 2, 3 }, { 0xFFFFFFFFFFFFFFFF, 1, 2, 4 } }, // A < B
+        { { 0xFFFFFFFFFFFFFFFF, 1, 2, 4 }, { 0xFFFFFFFFFFFFFFFF, 1, 2, 3 } }, // quotient 1
+    };
+#if defined(BIGINT_STATS)
+    uint64_t Corrections = BigintStatsSnapshot().Iterations[BigintLoop_QuotientCorrections];
+#endif
+    for (uint32_t Index = 0; Index < sizeof(EqualTop) / sizeof(EqualTop[0]); ++Index)
+    {
+        CheckDivision(FromMostSignificant(EqualTop[Index][0]), FromMostSignificant(EqualTop[Index][1]));
+    }
+#if defined(BIGINT_STATS)
+    TEST_CHECK(BigintStatsSnapshot().Iterations[BigintLoop_QuotientCorrections] > Corrections);
+#endif
+
+    for (uint32_t Index = 0; Index < sizeof(TestAddBackVectors) / sizeof(TestAddBackVectors[0]); ++Index)
+    {
+#if defined(BIGINT_STATS)
+        uint64_t AddBacks = BigintStatsSnapshot().Iterations[BigintLoop_AddBacks];
+#endif
+        CheckDivision(FromMostSignificant(TestAddBackVectors[Index][0]), FromMostSignificant(TestAddBackVectors[Index][1]));
+#if defined(BIGINT_STATS)
+        TEST_CHECK(BigintStatsSnapshot().Iterations[BigintLoop_AddBacks] > AddBacks);
+#endif
+    }
+
+    // Dividing by one and by itself, and the single-part fast paths.
+    uint512 Max = uint512(0) - 1;
+    CheckDivision(Max, uint512(1));
+    CheckDivision(Max, Max);
+    CheckDivision(Max, uint512(0xFFFFFFFFFFFFFFFF));
+    CheckDivision(Max, uint512(3));
+    CheckDivision(uint512(0), Max);
+    TestGroupEnd();
+}
+
+template <uint32_t Bits>
+static void
+TestDivisionRandom(random_xoshiro256* Generator, uint32_t Count)
+{
+    char Name[64];
+    snprintf(Name, sizeof(Name), "division: random %u-bit", Bits);
+    TestGroupBegin(Name);
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        uintn<Bits> A = TestOperand<Bits>(Generator);
+        uintn<Bits> B = TestOperand<Bits>(Generator);
+        if (B == 0) { B = 1; }
+        if (!CheckDivision(A, B)) { break; }
+
+        // The single-part path agrees with the full one.
+        uint64_t Divisor = B.Parts[0] | 1;
+        uint64_t Remainder;
+        uintn<Bits> Quotient = UIntDivideByPart(A, Divisor, &Remainder);
+        uintn_division_result<Bits> Expected = UIntDivision(A, uintn<Bits>(Divisor));
+        TEST_CHECK(Quotient == Expected.Quotient && uintn<Bits>(Remainder) == Expected.Remainder);
+    }
+    TestGroupEnd();
+}
+
+// The single-part comparisons against the full-width ones, on values around
+// the part boundary.
+static void
+TestComparePart()
+{
+    TestGroupBegin("compare: against a single part");
+    const uint64_t Parts[] = { 0, 1, 2, 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFE, 0xFFFFFFFFFFFFFFFF };
+    for (uint32_t High = 0; High < 2; ++High)
+    {
+        for (uint32_t LeftIndex = 0; LeftIndex < sizeof(Parts) / sizeof(Parts[0]); ++LeftIndex)
+        {
+            uint256 Left = Parts[LeftIndex];
+            Left.Parts[3] = High;
+            for (uint32_t RightIndex = 0; RightIndex < sizeof(Parts) / sizeof(Parts[0]); ++RightIndex)
+            {
+                uint64_t Right = Parts[RightIndex];
+                uint256 WideRight = Right;
+                TEST_CHECK((Left < Right) == (Left < WideRight));
+                TEST_CHECK((Left > Right) == (Left > WideRight));
+                TEST_CHECK((Left <= Right) == (Left <= WideRight));
+                TEST_CHECK((Left >= Right) == (Left >= WideRight));
+                TEST_CHECK((Left == Right) == (Left == WideRight));
+                TEST_CHECK((Left != Right) == (Left != WideRight));
+            }
+        }
+    }
+#if defined(BIGINT_STATS)
+    // One comparison each, not a less-than and an equality.
+    uint64_t Calls = BigintStatsSnapshot().Calls[BigintOp_Less] + BigintStatsSnapshot().Calls[BigintOp_Equal];
+    volatile bool Greater = uint256(5) > (uint64_t)3;
+    volatile bool LessEqual = uint256(5) <= (uint64_t)3;
+    (void)Greater;
+    (void)LessEqual;
+    TEST_CHECK(BigintStatsSnapshot().Calls[BigintOp_Less] + BigintStatsSnapshot().Calls[BigintOp_Equal] == Calls + 2);
+#endif
+    TestGroupEnd();
+}
+
+//
+// Modular inverse
+//
+
+template <uint32_t Bits>
+static void
+CheckModularInverse(const uintn<Bits>& A, const uintn<Bits>& Modulus)
+{
+    uintn<Bits> Inverse = 0;
+    bool Exists = (UIntGCD(A % Modulus, Modulus) == 1);
+    if (!TEST_CHECK(UIntModularInverse(A, Modulus, &Inverse) == Exists) || !Exists) { return; }
+    TEST_CHECK(Inverse < Modulus);
+    TEST_CHECK(UIntMultiplyWide(A % Modulus, Inverse) % Widen(Modulus) == 1);
+}
+
+template <uint32_t Bits>
+static void
+TestModularInverse(random_xoshiro256* Generator, uint32_t Count)
+{
+    char Name[64];
+    snprintf(Name, sizeof(Name), "modular inverse: %u-bit", Bits);
+    TestGroupBegin(Name);
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        uintn<Bits> Modulus = TestOperand<Bits>(Generator);
+        if (Modulus <= 1) { Modulus = 2; }
+        uintn<Bits> A = TestOperand<Bits>(Generator);
+        // Alternate odd and even moduli; the even ones take the other path.
+        Modulus.Parts[0] = (Iteration & 1) ? (Modulus.Parts[0] | 1) : (Modulus.Parts[0] & ~(uint64_t)1);
+        if (Modulus <= 1) { Modulus = 2; }
+        CheckModularInverse(A, Modulus);
+        // An odd A as well, so the even moduli mostly have an inverse to check
+        // rather than a refusal.
+        A.Parts[0] |= 1;
+        CheckModularInverse(A, Modulus);
+    }
+
+    // RSA's private exponent: 65537^-1 mod an even lambda(N), and the trivial
+    // and no-inverse cases.
+    uintn<Bits> Lambda = (uintn<Bits>(0xFFFFFFFFFFFFFFC5) << (Bits / 2)) - 2;
+    CheckModularInverse(uintn<Bits>(65537), Lambda);
+    CheckModularInverse(uintn<Bits>(1), uintn<Bits>(2));
+    CheckModularInverse(uintn<Bits>(0), Lambda);
+    CheckModularInverse(uintn<Bits>(6), uintn<Bits>(9));
+    CheckModularInverse(uintn<Bits>(4), uintn<Bits>(10));
+    CheckModularInverse(Lambda + 1, Lambda); // A reduced to 1
+    TestGroupEnd();
+}
+
+// Euclid by remainders, as the reference for the binary GCD.
+template <uint32_t Bits>
+static uintn<Bits>
+TestEuclidGCD(uintn<Bits> A, uintn<Bits> B)
+{
+    while (B != 0)
+    {
+        uintn<Bits> Remainder = A % B;
+        A = B;
+        B = Remainder;
+    }
+    return A;
+}
+
+template <uint32_t Bits>
+static void
+TestGCD(random_xoshiro256* Generator, uint32_t Count)
+{
+    char Name[64];
+    snprintf(Name, sizeof(Name), "gcd and batch inverse: %u-bit", Bits);
+    TestGroupBegin(Name);
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        // A shared factor, often with a power of two in it.
+        uintn<Bits> Common = RandomUInt<Bits>(Generator, 1) << (uint32_t)(RandomNext(Generator) % 8);
+        uintn<Bits> A = TestOperand<Bits>(Generator) * Common;
+        uintn<Bits> B = TestOperand<Bits>(Generator) * Common;
+        TEST_CHECK(UIntGCD(A, B) == TestEuclidGCD(A, B));
+    }
+    TEST_CHECK(UIntGCD(uintn<Bits>(0), uintn<Bits>(12)) == 12);
+    TEST_CHECK(UIntGCD(uintn<Bits>(12), uintn<Bits>(0)) == 12);
+    TEST_CHECK(UIntGCD(uintn<Bits>(1) << (Bits - 1), uintn<Bits>(1) << 7) == (uintn<Bits>(1) << 7));
+
+    // Montgomery's trick against one inversion per value.
+    const uint32_t ValueCount = 17;
+    montgomery_context<Bits> Context;
+    uintn<Bits> Modulus = RandomUInt<Bits>(Generator);
+    Modulus.Parts[0] |= 1;
+    MontgomeryInit(&Context, Modulus);
+    uintn<Bits> Values[ValueCount];
+    uintn<Bits> Inverses[ValueCount];
+    for (uint32_t Index = 0; Index < ValueCount; ++Index)
+    {
+        do { Values[Index] = RandomUInt<Bits>(Generator) % Modulus; } while (UIntGCD(Values[Index], Modulus) != 1);
+        Values[Index] = ToMontgomery(&Context, Values[Index]);
+    }
+    if (TEST_CHECK(MontgomeryBatchInverse(&Context, Values, Inverses, ValueCount)))
+    {
+        for (uint32_t Index = 0; Index < ValueCount; ++Index)
+        {
+            uintn<Bits> Expected = 0;
+            UIntModularInverse(FromMontgomery(&Context, Values[Index]), Modulus, &Expected);
+            TEST_CHECK(FromMontgomery(&Context, Inverses[Index]) == Expected);
+        }
+    }
+    // A value sharing a factor with the modulus makes the whole batch fail.
+    Values[ValueCount / 2] = ToMontgomery(&Context, uintn<Bits>(0));
+    TEST_CHECK(!MontgomeryBatchInverse(&Context, Values, Inverses, ValueCount));
+    TEST_CHECK(MontgomeryBatchInverse(&Context, Values, Inverses, 0));
+    TestGroupEnd();
+}
+
+//
+// Square roots
+//
+
+template <uint32_t Bits>
+static void
+CheckSquareRoot(const uintn<Bits>& N)
+{
+    uintn<Bits> Remainder;
+    uintn<Bits> Root = UIntSquareRoot(N, &Remainder);
+    uintn<2 * Bits> Square = UIntSquare(Root);
+    uintn<2 * Bits> NextRoot = Widen(Root) + 1;
+    TEST_CHECK(Square <= Widen(N));
+    TEST_CHECK(NextRoot * NextRoot > Widen(N));
+    TEST_CHECK(Widen(Remainder) == Widen(N) - Square);
+
+    uintn<Bits> SquareRoot = 0;
+    bool IsSquare = UIntIsPerfectSquare(N, &SquareRoot);
+    TEST_CHECK(IsSquare == (Remainder == 0));
+    if (IsSquare) { TEST_CHECK(SquareRoot == Root); }
+}
+
+template <uint32_t Bits>
+static void
+TestSquareRoot(random_xoshiro256* Generator, uint32_t Count)
+{
+    char Name[64];
+    snprintf(Name, sizeof(Name), "square root: %u-bit", Bits);
+    TestGroupBegin(Name);
+    for (uint64_t Small = 0; Small < 1000; ++Small) { CheckSquareRoot(uintn<Bits>(Small)); }
+    CheckSquareRoot(uintn<Bits>(0) - 1);
+    CheckSquareRoot(uintn<Bits>(1) << (Bits - 1));
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        uint32_t BitCount = 1 + (uint32_t)(RandomNext(Generator) % Bits);
+        CheckSquareRoot(RandomUIntWithBits<Bits>(Generator, BitCount));
+
+        // Squares and their neighbours, which the residue filters cannot
+        // tell apart.
+        uintn<Bits> Root = RandomUIntWithBits<Bits>(Generator, 2 + (uint32_t)(RandomNext(Generator) % (Bits / 2 - 1)));
+        uintn<Bits> Square = Root * Root;
+        uintn<Bits> Found = 0;
+        TEST_CHECK(UIntIsPerfectSquare(Square, &Found) && Found == Root);
+        TEST_CHECK(!UIntIsPerfectSquare(Square - 1));
+        TEST_CHECK(!UIntIsPerfectSquare(Square + 1));
+        CheckSquareRoot(Square - 1);
+        CheckSquareRoot(Square);
+    }
+    TestGroupEnd();
+}
+
+//
+// Text conversion
+//
+
+// One digit per division by ten, as the reference for the 19-digit chunks.
+template <uint32_t Bits>
+static uint32_t
+TestFormatDecimalReference(uintn<Bits> N, char* Buffer)
+{
+    char Reversed[UINTN_DECIMAL_DIGITS(Bits)];
+    uint32_t Length = 0;
+    do
+    {
+        uint64_t Digit = 0;
+        N = UIntDivideByPart(N, 10, &Digit);
+        Reversed[Length++] = (char)('0' + Digit);
+    } while (N != 0);
+    for (uint32_t Index = 0; Index < Length; ++Index) { Buffer[Index] = Reversed[Length - 1 - Index]; }
+    Buffer[Length] = 0;
+    return Length;
+}
+
+template <uint32_t Bits>
+static void
+CheckTextRoundTrip(const uintn<Bits>& N)
+{
+    char Decimal[UINTN_DECIMAL_DIGITS(Bits) + 1];
+    char Expected[UINTN_DECIMAL_DIGITS(Bits) + 1];
+    uint32_t Length = UIntFormatDecimal(N, Decimal, sizeof(Decimal));
+    TEST_CHECK(Length == TestFormatDecimalReference(N, Expected) && strcmp(Decimal, Expected) == 0);
+    uintn<Bits> Parsed = 0;
+    TEST_CHECK(UIntParseDecimal(Decimal, Length, &Parsed) && Parsed == N);
+    // One character short of the digits and the terminator.
+    TEST_CHECK(UIntFormatDecimal(N, Decimal, Length) == 0);
+
+    char Hex[UINTN_HEX_DIGITS(Bits) + 3] = "0x";
+    Length = UIntFormatHex(N, Hex + 2, sizeof(Hex) - 2);
+    TEST_CHECK(Length == ((N == 0) ? 1 : (SignificantBitCount(N) + 3) / 4));
+    Parsed = 0;
+    TEST_CHECK(UIntParseHex(Hex + 2, Length, &Parsed) && Parsed == N);
+    Parsed = 0;
+    TEST_CHECK(UIntParseHex(Hex, Length + 2, &Parsed) && Parsed == N);
+    TEST_CHECK(UIntFormatHex(N, Hex, Length) == 0);
+}
+
+template <uint32_t Bits>
+static void
+TestTextConversion(random_xoshiro256* Generator, uint32_t Count)
+{
+    char Name[64];
+    snprintf(Name, sizeof(Name), "format and parse: %u-bit", Bits);
+    TestGroupBegin(Name);
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        uint32_t BitCount = 1 + (uint32_t)(RandomNext(Generator) % Bits);
+        CheckTextRoundTrip(RandomUIntWithBits<Bits>(Generator, BitCount));
+        CheckTextRoundTrip(TestOperand<Bits>(Generator));
+    }
+    // Around the chunk size: 10^19 - 1 fills one chunk, 10^19 starts a second.
+    CheckTextRoundTrip(uintn<Bits>(0));
+    CheckTextRoundTrip(uintn<Bits>(9999999999999999999u));
+    CheckTextRoundTrip(uintn<Bits>(10000000000000000000u));
+    CheckTextRoundTrip(uintn<Bits>(10000000000000000000u) * uintn<Bits>(10000000000000000000u));
+    CheckTextRoundTrip(uintn<Bits>(0) - 1);
+
+    // The largest value is accepted, one more is not, in either base.
+    uintn<Bits> Largest = uintn<Bits>(0) - 1;
+    char Text[UINTN_DECIMAL_DIGITS(Bits) + 2];
+    uint32_t Length = UIntFormatDecimal(Largest, Text, sizeof(Text));
+    uint32_t Position = Length - 1;
+    while (Text[Position] == '9') { Text[Position--] = '0'; }
+    ++Text[Position];
+    uintn<Bits> Parsed = 7;
+    TEST_CHECK(!UIntParseDecimal(Text, Length, &Parsed) && Parsed == 7);
+    Text[0] = '1';
+    memset(Text + 1, '0', UINTN_HEX_DIGITS(Bits));
+    TEST_CHECK(!UIntParseHex(Text, UINTN_HEX_DIGITS(Bits) + 1, &Parsed) && Parsed == 7);
+    Text[0] = '0';
+    Text[UINTN_HEX_DIGITS(Bits)] = '1';
+    TEST_CHECK(UIntParseHex(Text, UINTN_HEX_DIGITS(Bits) + 1, &Parsed) && Parsed == 1);
+    TestGroupEnd();
+}
+
+static void
+TestTextKnownValues()
+{
+    TestGroupBegin("format and parse: known values");
+    const char* MaxDecimal = "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+    char Text[UINTN_DECIMAL_DIGITS(256) + 1];
+    TEST_CHECK(UIntFormatDecimal(uint256(0) - 1, Text, sizeof(Text)) == 78 && strcmp(Text, MaxDecimal) == 0);
+    TEST_CHECK(UIntFormatHex(uint256(0xDEADBEEF) << 200, Text, sizeof(Text)) == 58);
+    TEST_CHECK(strncmp(Text, "deadbeef000", 11) == 0);
+
+    uint256 Parsed = 7;
+    TEST_CHECK(UIntParseDecimal("000123", 6, &Parsed) && Parsed == 123);
+    TEST_CHECK(UIntParseHex("0XaBcD", 6, &Parsed) && Parsed == 0xABCD);
+    // An empty string, a bare prefix, and stray characters are all rejected
+    // without touching the result.
+    Parsed = 7;
+    TEST_CHECK(!UIntParseDecimal("", 0, &Parsed));
+    TEST_CHECK(!UIntParseDecimal("12a4", 4, &Parsed));
+    TEST_CHECK(!UIntParseDecimal("-1", 2, &Parsed));
+    TEST_CHECK(!UIntParseDecimal("1 2", 3, &Parsed));
+    TEST_CHECK(!UIntParseHex("0x", 2, &Parsed));
+    TEST_CHECK(!UIntParseHex("12g4", 4, &Parsed));
+    TEST_CHECK(!UIntParseHex("0x12:", 5, &Parsed));
+    TEST_CHECK(Parsed == 7);
+    TestGroupEnd();
+}
+
+//
+// Literals
+//
+
+// Built at compile time: these only compile if the literal operators are
+// constant expressions.
+static constexpr uint256 TestP256Prime = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF_u256;
+static_assert(TestP256Prime.Parts[0] == 0xFFFFFFFFFFFFFFFF && TestP256Prime.Parts[1] == 0x00000000FFFFFFFF &&
+              TestP256Prime.Parts[2] == 0 && TestP256Prime.Parts[3] == 0xFFFFFFFF00000001,
+              "hex _u256 literal");
+static constexpr uint512 TestTopBit = 0b1'0000000000000000000000000000000000000000000000000000000000000000_u512;
+static_assert(TestTopBit.Parts[0] == 0 && TestTopBit.Parts[1] == 1, "binary _u512 literal");
+static_assert((18446744073709551616_u256).Parts[1] == 1 && (18446744073709551616_u256).Parts[0] == 0,
+              "decimal literal past unsigned long long");
+
+static void
+TestLiterals()
+{
+    TestGroupBegin("literals: _u256, _u512, _u1024");
+    uint256 Parsed = 0;
+    const char* P256Decimal = "115792089210356248762697446949407573530086143415290314195533631308867097853951";
+    TEST_CHECK(UIntParseDecimal(P256Decimal, (uint32_t)strlen(P256Decimal), &Parsed) && Parsed == TestP256Prime);
+    TEST_CHECK(115792089210356248762697446949407573530086143415290314195533631308867097853951_u256 == TestP256Prime);
+    TEST_CHECK(0xffffffff00000001'00000000'00000000'00000000'ffffffff'ffffffff'ffffffff_u256 == TestP256Prime);
+    TEST_CHECK(0x0000FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF_u256 == TestP256Prime);
+
+    // Octal: 2^255 + 1.
+    TEST_CHECK(010000000000000000000000000000000000000000000000000000000000000000000000000000000000001_u256 ==
+               (uint256(1) << 255) + 1);
+    TEST_CHECK(0_u512 == 0);
+    TEST_CHECK(0x0_u512 == 0);
+    TEST_CHECK(1'000'000_u512 == 1000000);
+    TEST_CHECK(TestTopBit == (uint512(1) << 64));
+
+    // The largest 1024-bit value, in decimal and hex.
+    TEST_CHECK(179769313486231590772930519078902473361797697894230657273430081157732675805500963132708477322407536021120113879871393357658789768814416622492847430639474124377767893424865485276302219601246094119453082952085005768838150682342462881473913110540827237163350510684586298239947245938479716304835356329624224137215_u1024 ==
+               uint1024(0) - 1);
+    TEST_CHECK(0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF_u1024 ==
+               uint1024(0) - 1);
+    TestGroupEnd();
+}
+
+//
+// Random number generators
+//
+
+// Known answers from the reference xoshiro256** with state {1, 2, 3, 4}, and
+// its jump functions applied to that state.
+static void
+TestXoshiro()
+{
+    TestGroupBegin("xoshiro256**: known answers");
+    static const uint64_t Expected[6] =
+    {
+        0x2D00, 0, 0x5A007080, 0x10E0000000009D80, 0x10E0B61CE1009D80, 0x0870021CE143AD00,
+    };
+    random_xoshiro256 Generator = {{ 1, 2, 3, 4 }};
+    for (uint32_t Index = 0; Index < 6; ++Index) { TEST_CHECK(RandomNext(&Generator) == Expected[Index]); }
+
+    static const uint64_t Jumped[4] = { 0x8C7A153956B5F3D1, 0x701F1A713401D85E, 0x6527F66A65469085, 0x8386B786C4408050 };
+    static const uint64_t LongJumped[4] = { 0x096A8EB71295A400, 0xDBF84991E50F4516, 0x534EE745810D2A0E, 0x31655CA1A2215BF1 };
+    random_xoshiro256 Jump = {{ 1, 2, 3, 4 }};
+    random_xoshiro256 LongJump = {{ 1, 2, 3, 4 }};
+    XoshiroJump(&Jump);
+    XoshiroLongJump(&LongJump);
+    TEST_CHECK(memcmp(Jump.State, Jumped, sizeof(Jumped)) == 0);
+    TEST_CHECK(memcmp(LongJump.State, LongJumped, sizeof(LongJumped)) == 0);
+
+    // Seeding goes through splitmix64, whose first output for 0 is well known.
+    XoshiroSeed(&Generator, 0);
+    TEST_CHECK(Generator.State[0] == 0xE220A8397B1DCDAF);
+    TEST_CHECK(Generator.State[3] == 0xF88BB8A8724C81EC);
+    TEST_CHECK(RandomNext(&Generator) == 0x99EC5F36CB75F2B4);
+
+    // The bulk fill is the same sequence as one part at a time.
+    random_xoshiro256 Single;
+    XoshiroSeed(&Single, 99);
+    XoshiroSeed(&Generator, 99);
+    uint64_t Parts[13];
+    RandomFill(&Generator, Parts, 13);
+    for (uint32_t Index = 0; Index < 13; ++Index) { TEST_CHECK(Parts[Index] == RandomNext(&Single)); }
+    TestGroupEnd();
+}
+
+// The RFC 7539 block function vectors. The RFC splits the last four words into
+// a 32-bit counter and a 96-bit nonce; here they are a 64-bit block index and a
+// 64-bit stream, which is the same layout with the nonce's first word as the
+// counter's top half.
+static void
+TestChaCha()
+{
+    TestGroupBegin("chacha20: known answers");
+    static const uint64_t Key[4] = { 0x0706050403020100, 0x0F0E0D0C0B0A0908, 0x1716151413121110, 0x1F1E1D1C1B1A1918 };
+    static const uint64_t Block[8] =
+    {
+        0x15593BD1E4E7F110, 0xC47120A31FDD0F50, 0x0368C033C7F4D1C7, 0x4E6CD4C39AAA2204,
+        0x09AA9F07466482D2, 0xA2028BD905D7C214, 0xB94E16DED19C12B5, 0x4E3C50A2E883D0CB,
+    };
+    random_chacha20 Generator;
+    ChaChaSeed(&Generator, Key, 0x4A000000);
+    ChaChaSeek(&Generator, 1 | ((uint64_t)0x09000000 << 32));
+    for (uint32_t Index = 0; Index < 8; ++Index) { TEST_CHECK(RandomNext(&Generator) == Block[Index]); }
+
+    static const uint64_t ZeroKey[4] = {};
+    static const uint64_t ZeroBlock[8] =
+    {
+        0x903DF1A0ADE0B876, 0x28BD8653E56A5D40, 0x1AED8DA0B819D2BD, 0xC70D778BCCEF36A8,
+        0x8D4857517C5941DA, 0x374AD8B83FE02477, 0x1CA11815F4B8436A, 0x8665EEB269B687C3,
+    };
+    ChaChaSeed(&Generator, ZeroKey, 0);
+    for (uint32_t Index = 0; Index < 8; ++Index) { TEST_CHECK(RandomNext(&Generator) == ZeroBlock[Index]); }
+
+    // Bulk fills that start and end mid-block, and a seek back, all give the
+    // same parts as reading one at a time.
+    uint64_t Expected[40];
+    uint64_t Parts[40];
+    ChaChaSeed(&Generator, (uint64_t)7, 3);
+    for (uint32_t Index = 0; Index < 40; ++Index) { Expected[Index] = RandomNext(&Generator); }
+    ChaChaSeek(&Generator, 0);
+    RandomFill(&Generator, Parts, 3);
+    RandomFill(&Generator, Parts + 3, 21);
+    RandomFill(&Generator, Parts + 24, 16);
+    TEST_CHECK(memcmp(Parts, Expected, sizeof(Parts)) == 0);
+    ChaChaSeek(&Generator, 2);
+    TEST_CHECK(RandomNext(&Generator) == Expected[16]);
+
+    // The block counter carries into its top half.
+    ChaChaSeek(&Generator, 0xFFFFFFFF);
+    RandomFill(&Generator, Parts, 9);
+    random_chacha20 Carried = Generator;
+    ChaChaSeek(&Carried, (uint64_t)1 << 32);
+    TEST_CHECK(RandomNext(&Carried) == Parts[8]);
+
+    // Another stream under the same key is a different sequence.
+    ChaChaSeed(&Generator, (uint64_t)7, 4);
+    TEST_CHECK(RandomNext(&Generator) != Expected[0]);
+    TestGroupEnd();
+}
+
+//
+// Primality
+//
+
+// Base-2 strong pseudoprimes above the trial division limit whose prime
+// factors are all above the table's largest prime, so nothing before the
+// Lucas test can reject them.
+static const char* TestStrongPseudoprimesBase2[] =
+{
+    "27331921",                   // 3697 * 7393
+    "27509653",                   // 3709 * 7417
+    "52204237",                   // 3613 * 14449
+    "55729957",                   // 3733 * 14929
+    "58449847",                   // 3823 * 15289
+    "68512867",                   // 4139 * 16553
+    "69176647",                   // 4159 * 16633
+    "72543547",                   // 4259 * 17033
+    "3825123056546413051",        // 149491 * 747451 * 34233211, strong to bases 2..23
+    "318665857834031151167461",   // 399165290221 * 798330580441, bases 2..37
+    "3317044064679887385961981",  // 1287836182261 * 2575672364521, bases 2..41
+};
+
+static void
+TestBPSW(random_xoshiro256* Generator)
+{
+    TestGroupBegin("primality: BPSW and Miller-Rabin");
+    for (uint32_t Index = 0; Index < sizeof(TestStrongPseudoprimesBase2) / sizeof(TestStrongPseudoprimesBase2[0]); ++Index)
+    {
+        uint512 N = TestDecimal(TestStrongPseudoprimesBase2[Index]);
+        montgomery512 Context;
+        MontgomeryInit(&Context, N);
+        uint512 D;
+        uint32_t S;
+        SplitOffPowerOfTwo(N - 1, &D, &S);
+        TEST_CHECK(IsStrongProbablePrimeBase2(&Context, D, S));
+        TEST_CHECK(PrimalityTestBPSW(N) == 0);
+        TEST_CHECK(!IsProbablePrimeBPSW(N));
+        // A composite survives 32 random rounds with probability below 2^-64.
+        TEST_CHECK(PrimalityTestRandom(N, 32, Generator) == 0);
+    }
+
+    // Small ones are caught by trial division, which returns the factor.
+    TEST_CHECK(PrimalityTestBPSW(uint512(2047)) == 23);
+    TEST_CHECK(PrimalityTestBPSW(uint512(3277)) == 29);
+    TEST_CHECK(PrimalityTestBPSW(uint512(4033)) == 37);
+    TEST_CHECK(PrimalityTestBPSW(uint512(561)) == 3);
+
+    // Mersenne primes, and their composite neighbours.
+    const uint32_t MersenneExponents[] = { 61, 89, 107, 127 };
+    for (uint32_t Index = 0; Index < sizeof(MersenneExponents) / sizeof(MersenneExponents[0]); ++Index)
+    {
+        uint512 Mersenne = (uint512(1) << MersenneExponents[Index]) - 1;
+        TEST_CHECK(PrimalityTestBPSW(Mersenne) == 1);
+        TEST_CHECK(PrimalityTestRandom(Mersenne, 8, Generator) == 1);
+        TEST_CHECK(PrimalityTestBPSW(Mersenne + 2) != 1);
+    }
+    // The largest primes below 2^256 and 2^512; everything between them and
+    // the power of two is composite.
+    TEST_CHECK(PrimalityTestBPSW((uint512(1) << 256) - 189) == 1);
+    TEST_CHECK(PrimalityTestBPSW(uint512(0) - 569) == 1);
+    for (uint64_t Offset = 1; Offset < 569; Offset += 2) { TEST_CHECK(PrimalityTestBPSW(uint512(0) - Offset) != 1); }
+    TEST_CHECK(PrimalityTestBPSW(0) == 0);
+    TEST_CHECK(PrimalityTestBPSW(1) == 0);
+    TEST_CHECK(PrimalityTestBPSW(2) == 1);
+    TestGroupEnd();
+}
+
+// Smallest prime factor by plain trial division (N itself if prime), or 0 for
+// N < 2.
+static uint64_t
+TestSmallestFactor64(uint64_t N)
+{
+    if (N < 2) { return 0; }
+    for (uint64_t Divisor = 2; Divisor * Divisor <= N; ++Divisor)
+    {
+        if (N % Divisor == 0) { return Divisor; }
+    }
+    return N;
+}
+
+// Checks the PRIMALITY TESTS contract of PrimalityTestBPSW for every N in
+// [Begin, End) against plain trial division: 1 for primes, the smallest factor
+// when it is in the table, 0 for other composites.
+static void
+CheckTrialDivisionRange(uint64_t Begin, uint64_t End)
+{
+    uint64_t TableLimit = SmallPrimes()->Limit;
+    for (uint64_t N = Begin; N < End; ++N)
+    {
+        uint64_t Smallest = TestSmallestFactor64(N);
+        uint512 Expected = (N < 2) ? 0 : (Smallest == N) ? 1 : (Smallest <= TableLimit) ? Smallest : 0;
+        TEST_CHECK(PrimalityTestBPSW(uint512(N)) == Expected);
+    }
+}
+
+static void
+TestTrialDivision()
+{
+    // Both sides of the trial division limit, where the verdict switches from
+    // the table alone to Baillie-PSW.
+    TestGroupBegin("primality: trial division");
+    uint64_t Limit = SmallPrimeTrialLimit();
+    TEST_CHECK(Limit == (uint64_t)SMALL_PRIME_DEFAULT_LIMIT * SMALL_PRIME_DEFAULT_LIMIT);
+    CheckTrialDivisionRange(0, 5000);
+    CheckTrialDivisionRange(Limit - 3000, Limit + 3000);
+
+    // Table primes times a large prime, across every group of the table.
+    uint512 Mersenne127 = (uint512(1) << 127) - 1;
+    TEST_CHECK(PrimalityTestEarlyOut(Mersenne127) == 1);
+    TEST_CHECK(PrimalityTestEarlyOut(Mersenne127 * 3559 * 3571) == 3559);
+    const small_prime_table* Table = SmallPrimes();
+    for (uint32_t PrimeIndex = 0; PrimeIndex < Table->PrimeCount; ++PrimeIndex)
+    {
+        uint64_t Prime = Table->Primes[PrimeIndex].Prime;
+        TEST_CHECK(PrimalityTestEarlyOut(Mersenne127 * Prime) == Prime);
+    }
+
+    // A resized table moves the limit with it.
+    SmallPrimeTableInit(101);
+    TEST_CHECK(SmallPrimeTrialLimit() == 101 * 101);
+    CheckTrialDivisionRange(0, 20000);
+    SmallPrimeTableInit(SMALL_PRIME_DEFAULT_LIMIT);
+    TEST_CHECK(SmallPrimeTrialLimit() == Limit);
+    TestGroupEnd();
+}
+
+// NextPrime(N) is a prime and nothing between N and it is.
+static bool
+CheckNextPrime(uint512 N)
+{
+    uint512 Prime = NextPrime(N);
+    if (!TEST_CHECK(Prime >= N && PrimalityTestBPSW(Prime) == 1)) { return false; }
+    bool Passed = true;
+    for (uint512 Between = N; Between < Prime; Between += 1)
+    {
+        Passed &= TEST_CHECK(PrimalityTestBPSW(Between) != 1);
+    }
+    return Passed;
+}
+
+static void
+TestNextPrime(random_xoshiro256* Generator)
+{
+    TestGroupBegin("primality: NextPrime and RandomPrime");
+    // Up to and across the trial limit, where the sieve takes over.
+    uint64_t Limit = SmallPrimeTrialLimit();
+    uint64_t Expected = 0;
+    for (uint64_t N = 0; N < 3000; ++N)
+    {
+        Expected = (N <= 2) ? 2 : (Expected < N) ? N : Expected;
+        while (TestSmallestFactor64(Expected) != Expected) { ++Expected; }
+        TEST_CHECK(NextPrime(uint512(N)) == uint512(Expected));
+    }
+    for (uint64_t N = Limit - 3000; N < Limit + 3000; ++N)
+    {
+        if (Expected < N)
+        {
+            Expected = N;
+            while (TestSmallestFactor64(Expected) != Expected) { ++Expected; }
+        }
+        TEST_CHECK(NextPrime(uint512(N)) == uint512(Expected));
+    }
+
+    // Random starts, so the gaps cross sieve windows, and the top of the range.
+    for (uint32_t Iteration = 0; Iteration < 20; ++Iteration)
+    {
+        uint32_t Bits = (Iteration & 1) ? 512 : 64 + (uint32_t)(RandomNext(Generator) % 448);
+        if (!CheckNextPrime(RandomUIntWithBits<512>(Generator, Bits))) { break; }
+    }
+    TEST_CHECK(NextPrime(uint512(0) - 628) == uint512(0) - 569);
+    TEST_CHECK(NextPrime(uint512(0) - 1000) == uint512(0) - 975);
+    TEST_CHECK(NextPrime(uint512(0) - 568) == 0);
+
+    // Exactly the requested size, and the same prime for the same seed.
+    const uint32_t Sizes[] = { 2, 3, 17, 64, 65, 200, 512 };
+    for (uint32_t Index = 0; Index < sizeof(Sizes) / sizeof(Sizes[0]); ++Index)
+    {
+        random_xoshiro256 First, Second;
+        XoshiroSeed(&First, Sizes[Index]);
+        XoshiroSeed(&Second, Sizes[Index]);
+        uint512 Prime = RandomPrime(Sizes[Index], &First);
+        TEST_CHECK(SignificantBitCount(Prime) == Sizes[Index]);
+        TEST_CHECK(PrimalityTestBPSW(Prime) == 1);
+        TEST_CHECK(RandomPrime(Sizes[Index], &Second) == Prime);
+    }
+    TestGroupEnd();
+}
+
+// The batch API follows PrimalityTestBPSW element by element, serial and
+// threaded.
+static void
+TestPrimalityBatch(random_xoshiro256* Generator)
+{
+    TestGroupBegin("primality: batch API");
+    const uint32_t Count = 301;
+    uint512 Candidates[Count];
+    uint512 Results[Count];
+    for (uint32_t Index = 0; Index < Count; ++Index)
+    {
+        uint32_t Pick = Index % 6;
+        if (Pick == 0) { Candidates[Index] = Index; }
+        else if (Pick == 1) { Candidates[Index] = NextPrime(RandomUIntWithBits<512>(Generator, 64 + Index)); }
+        else if (Pick == 2) { Candidates[Index] = TestDecimal(TestStrongPseudoprimesBase2[Index % (sizeof(TestStrongPseudoprimesBase2) / sizeof(TestStrongPseudoprimesBase2[0]))]); }
+        else { Candidates[Index] = RandomUIntWithBits<512>(Generator, 2 + (uint32_t)(RandomNext(Generator) % 511)); }
+    }
+
+    PrimalityTestBatch(Candidates, Results, Count);
+    for (uint32_t Index = 0; Index < Count; ++Index) { TEST_CHECK(Results[Index] == PrimalityTestBPSW(Candidates[Index])); }
+    const uint32_t ThreadCounts[] = { 1, 3, 8 };
+    for (uint32_t Thread = 0; Thread < sizeof(ThreadCounts) / sizeof(ThreadCounts[0]); ++Thread)
+    {
+        for (uint32_t Index = 0; Index < Count; ++Index) { Results[Index] = 7; }
+        PrimalityTestBatchParallel(Candidates, Results, Count, ThreadCounts[Thread]);
+        for (uint32_t Index = 0; Index < Count; ++Index) { TEST_CHECK(Results[Index] == PrimalityTestBPSW(Candidates[Index])); }
+    }
+    PrimalityTestBatch(Candidates, Results, 0);
+    PrimalityTestBatchParallel(Candidates, Results, 0, 4);
+    TestGroupEnd();
+}
+
+// The parallel searches promise the same answer for every thread count.
+static void
+TestParallelSearch(random_xoshiro256* Generator)
+{
+    TestGroupBegin("parallel: NextPrime and RandomPrime");
+    const uint32_t ThreadCounts[] = { 1, 2, 3, 4, 8 };
+    const uint32_t ThreadCountCount = sizeof(ThreadCounts) / sizeof(ThreadCounts[0]);
+    uint512 Starts[12] = { 0, 1000, SmallPrimeTrialLimit() - 10, uint512(0) - 1000, uint512(0) - 568 };
+    for (uint32_t Index = 5; Index < sizeof(Starts) / sizeof(Starts[0]); ++Index)
+    {
+        Starts[Index] = RandomUIntWithBits<512>(Generator, 64 + (uint32_t)(RandomNext(Generator) % 449));
+    }
+    for (uint32_t Index = 0; Index < sizeof(Starts) / sizeof(Starts[0]); ++Index)
+    {
+        uint512 Expected = NextPrime(Starts[Index]);
+        for (uint32_t Thread = 0; Thread < ThreadCountCount; ++Thread)
+        {
+            TEST_CHECK(ParallelNextPrime(Starts[Index], ThreadCounts[Thread]) == Expected);
+        }
+    }
+
+    const uint32_t Sizes[] = { 2, 16, 64, 200, 512 };
+    for (uint32_t Index = 0; Index < sizeof(Sizes) / sizeof(Sizes[0]); ++Index)
+    {
+        uint64_t Seed = RandomNext(Generator);
+        uint512 Expected = ParallelRandomPrime(Sizes[Index], Seed, 1);
+        TEST_CHECK(SignificantBitCount(Expected) == Sizes[Index] && PrimalityTestBPSW(Expected) == 1);
+        for (uint32_t Thread = 1; Thread < ThreadCountCount; ++Thread)
+        {
+            TEST_CHECK(ParallelRandomPrime(Sizes[Index], Seed, ThreadCounts[Thread]) == Expected);
+        }
+    }
+    TestGroupEnd();
+}
+
+//
+// Factoring
+//
+
+struct test_factor_case
+{
+    const char* N;
+    const char* SmallestFactor;
+};
+
+static void
+TestPollardRho()
+{
+    TestGroupBegin("factoring: Pollard rho");
+    const test_factor_case Cases[] =
+    {
+        { "4708371825938606471441", "5806583323" },                   // 10 and 12 digits
+        { "6425823120892979914499", "68224977649" },                  // 11 and 11 digits
+        { "6272697690782928076848590527", "730429788289" },           // 12 and 16 digits
+        { "944805146144835487097905007571811", "9636183295201" },     // 13 and 20 digits
+        { "4221098232962876348422777817", "43768927369781" },         // 14 and 14 digits
+        { "444407887392802397327339218273943461980068294927669623651122337", "5806583323" }, // 10, 13 and 40 digits
+        { "18446744073709551617", "274177" },                         // 2^64 + 1
+        // Prime powers.
+        { "553978450943343466261123767857", "8212920593" },           // 10 digits, cubed
+        { "2939901217829922463443882577943540864281", "54220855930443614341" }, // 20 digits, squared
+        { "946296712867363790926835417279283570179832289201", "986295003157" }, // 12 digits, fourth power
+        { "730740509342116215665924924653511768146918153249", "3738975649" }, // 10 digits, fifth power
+        // Repeated factors next to other ones.
+        { "50125151656115027561339400049793", "8400709601" },         // 10 digits squared, times 12
+        { "1197501264130208465409429369468333249029938981", "50965676071" }, // 11 digits cubed, times 13
+        // Table primes come from trial division.
+        { "12752041", "3571" },                                       // 3571^2
+        { "4294967297", "641" },                                      // 2^32 + 1
+    };
+    for (uint32_t Index = 0; Index < sizeof(Cases) / sizeof(Cases[0]); ++Index)
+    {
+        uint512 N = TestDecimal(Cases[Index].N);
+        uint512 Factor = PrimalityTestPollardRho(N);
+        TEST_CHECK(Factor == TestDecimal(Cases[Index].SmallestFactor));
+        TEST_CHECK(Factor > 1 && N % Factor == 0);
+    }
+
+    TEST_CHECK(PrimalityTestPollardRho((uint512(1) << 127) - 1) == 1);
+    TEST_CHECK(PrimalityTestPollardRho(TestDecimal("54220855930443614341")) == 1);
+    TEST_CHECK(PrimalityTestPollardRho(uint512(3571)) == 1);
+    TEST_CHECK(PrimalityTestPollardRho(uint512(1)) == 0);
+
+    // Two 19-20 digit factors are past the step budget: composite, no factor.
+    TEST_CHECK(PrimalityTestPollardRho(TestDecimal("142619818461699600615450260139306394231")) == 0);
+    TestGroupEnd();
+}
+
+//
+// Active-part tracking
+//
+
+// Every tracked result must match the plain uintn one and carry an exact
+// ActiveCount, or later operations would skip live parts.
+template <uint32_t Bits>
+static void
+CheckTracked(const uintn_tracked<Bits>& Result, const uintn<Bits>& Expected)
+{
+    TEST_CHECK(Result.Value == Expected);
+    TEST_CHECK(Result.ActiveCount == SignificantPartCount(Expected));
+}
+
+template <uint32_t Bits>
+static uintn<Bits>
+TestTrackedOperand(random_xoshiro256* Generator)
+{
+    // Mostly short values, which take the native and narrow paths.
+    uint64_t Pick = RandomNext(Generator) % 4;
+    if (Pick == 0) { return uintn<Bits>(RandomNext(Generator) >> (RandomNext(Generator) % 64)); }
+    if (Pick == 1) { return RandomUInt<Bits>(Generator, 1 + (uint32_t)(RandomNext(Generator) % 2)); }
+    return TestOperand<Bits>(Generator);
+}
+
+template <uint32_t Bits>
+static void
+TestTracked(random_xoshiro256* Generator, uint32_t Count)
+{
+    char Name[64];
+    snprintf(Name, sizeof(Name), "tracked: %u-bit", Bits);
+    TestGroupBegin(Name);
+    for (uint32_t Iteration = 0; Iteration < Count; ++Iteration)
+    {
+        uintn<Bits> A = TestTrackedOperand<Bits>(Generator);
+        uintn<Bits> B = TestTrackedOperand<Bits>(Generator);
+        uintn_tracked<Bits> TrackedA = A;
+        uintn_tracked<Bits> TrackedB = B;
+        CheckTracked(TrackedA, A);
+
+        CheckTracked(TrackedA + TrackedB, A + B);
+        CheckTracked(TrackedA - TrackedB, A - B);
+        CheckTracked(TrackedB - TrackedA, B - A);
+        CheckTracked(TrackedA * TrackedB, A * B);
+        TEST_CHECK((TrackedA < TrackedB) == (A < B));
+        TEST_CHECK((TrackedB < TrackedA) == (B < A));
+        TEST_CHECK((TrackedA == TrackedB) == (A == B));
+        TEST_CHECK(TrackedA == TrackedA && TrackedA <= TrackedA && !(TrackedA < TrackedA));
+
+        if (B != 0)
+        {
+            uintn_division_result<Bits> Expected = UIntDivision(A, B);
+            uintn_tracked_division_result<Bits> Division = UIntTrackedDivision(TrackedA, TrackedB);
+            CheckTracked(Division.Quotient, Expected.Quotient);
+            CheckTracked(Division.Remainder, Expected.Remainder);
+        }
+
+        uint32_t Shift = (uint32_t)(RandomNext(Generator) % Bits);
+        CheckTracked(TrackedA << Shift, A << Shift);
+        CheckTracked(TrackedA >> Shift, A >> Shift);
+
+        uintn_tracked<Bits> Compound = TrackedA;
+        Compound += TrackedB;
+        CheckTracked(Compound, A + B);
+        Compound -= TrackedA;
+        CheckTracked(Compound, B);
+        Compound *= TrackedA;
+        CheckTracked(Compound, B * A);
+        if (A != 0)
+        {
+            Compound %= TrackedA;
+            CheckTracked(Compound, (B * A) % A);
+        }
+    }
+
+    // Carries into a new part and borrows through all of them.
+    uintn_tracked<Bits> Top = uintn<Bits>(0xFFFFFFFFFFFFFFFF);
+    CheckTracked(Top + 1, uintn<Bits>(1) << 64);
+    CheckTracked(uintn_tracked<Bits>(0) - 1, uintn<Bits>(0) - 1);
+    CheckTracked((uintn_tracked<Bits>(0) - 1) + 1, uintn<Bits>(0));
+    CheckTracked(uintn_tracked<Bits>(5) - 5, uintn<Bits>(0));
+    CheckTracked(uintn_tracked<Bits>(uintn<Bits>(1) << (Bits - 1)) << 1, uintn<Bits>(0));
+    TestGroupEnd();
+}
+
+//
+// Batch kernels
+//
+
+template <uint32_t Bits>
+static void
+TestBatch(random_xoshiro256* Generator, uint32_t Count)
+{
+    uintn<Bits>* A = (uintn<Bits>*)malloc(Count * sizeof(uintn<Bits>));
+    uintn<Bits>* B = (uintn<Bits>*)malloc(Count * sizeof(uintn<Bits>));
+    uintn<Bits>* Results = (uintn<Bits>*)malloc(Count * sizeof(uintn<Bits>));
+    uint64_t* Remainders = (uint64_t*)malloc(Count * sizeof(uint64_t));
+    uint8_t* Less = (uint8_t*)malloc((Count + 7) / 8);
+    uint8_t* Equal = (uint8_t*)malloc((Count + 7) / 8);
+    for (uint32_t Index = 0; Index < Count; ++Index)
+    {
+        A[Index] = TestOperand<Bits>(Generator);
+        // Some lanes equal, or differing only in the lowest part, so the
+        // comparisons have to look all the way down.
+        uint64_t Pick = RandomNext(Generator) % 4;
+        B[Index] = (Pick < 2) ? A[Index] : TestOperand<Bits>(Generator);
+        if (Pick == 1) { B[Index].Parts[0] ^= 1; }
+    }
+
+    uintn_batch<Bits> BatchA, BatchB, BatchResult;
+    UIntBatchAllocate(&BatchA, Count);
+    UIntBatchAllocate(&BatchB, Count);
+    UIntBatchAllocate(&BatchResult, Count);
+    UIntBatchLoad(&BatchA, A);
+    UIntBatchLoad(&BatchB, B);
+
+    const uint64_t Divisors[] = { 1, 3, 10, 65521, 65536, 65537, 0xFFFFFFFF, 0xFFFFFFFFFFFFFFC5 };
+    const batch_isa ISAs[] = { BatchISA_Scalar, BatchISA_AVX2, BatchISA_AVX512 };
+    for (uint32_t ISAIndex = 0; ISAIndex < sizeof(ISAs) / sizeof(ISAs[0]); ++ISAIndex)
+    {
+        char Name[64];
+        const char* ISAName = BatchKernelsFor(ISAs[ISAIndex])->Name;
+        snprintf(Name, sizeof(Name), "batch: %s, %u x %u-bit", ISAName, Count, Bits);
+        TestGroupBegin(Name);
+        if (!BatchUseKernels(ISAs[ISAIndex]))
+        {
+            printf("skipped (not supported)\n");
+            continue;
+        }
+
+        UIntBatchAdd(&BatchResult, BatchA, BatchB);
+        UIntBatchStore(BatchResult, Results);
+        for (uint32_t Index = 0; Index < Count; ++Index) { TEST_CHECK(Results[Index] == A[Index] + B[Index]); }
+
+        UIntBatchSubtract(&BatchResult, BatchA, BatchB);
+        UIntBatchStore(BatchResult, Results);
+        for (uint32_t Index = 0; Index < Count; ++Index) { TEST_CHECK(Results[Index] == A[Index] - B[Index]); }
+
+        memset(Less, 0xFF, (Count + 7) / 8);
+        memset(Equal, 0xFF, (Count + 7) / 8);
+        UIntBatchLess(BatchA, BatchB, Less);
+        UIntBatchEqual(BatchA, BatchB, Equal);
+        for (uint32_t Index = 0; Index < Count; ++Index)
+        {
+            TEST_CHECK(((Less[Index / 8] >> (Index % 8)) & 1) == (A[Index] < B[Index]));
+            TEST_CHECK(((Equal[Index / 8] >> (Index % 8)) & 1) == (A[Index] == B[Index]));
+        }
+        if (Count % 8)
+        {
+            TEST_CHECK((Less[Count / 8] >> (Count % 8)) == 0);
+            TEST_CHECK((Equal[Count / 8] >> (Count % 8)) == 0);
+        }
+
+        for (uint32_t DivisorIndex = 0; DivisorIndex < sizeof(Divisors) / sizeof(Divisors[0]); ++DivisorIndex)
+        {
+            uint64_t Divisor = Divisors[DivisorIndex];
+            UIntBatchRemainderByPart(BatchA, Divisor, Remainders);
+            for (uint32_t Index = 0; Index < Count; ++Index)
+            {
+                uint64_t Expected;
+                UIntDivideByPart(A[Index], Divisor, &Expected);
+                TEST_CHECK(Remainders[Index] == Expected);
+            }
+        }
+        TestGroupEnd();
+    }
+    BatchUseKernels(BatchDetectISA());
+
+    UIntBatchFree(&BatchA);
+    UIntBatchFree(&BatchB);
+    UIntBatchFree(&BatchResult);
+    free(A);
+    free(B);
+    free(Results);
+    free(Remainders);
+    free(Less);
+    free(Equal);
+}
+
+int main(int ArgCount, char* ArgValues[])
+{
+    uint64_t Seed = (ArgCount > 1) ? strtoull(ArgValues[1], 0, 0) : 1;
+    random_xoshiro256 Generator;
+    XoshiroSeed(&Generator, Seed);
+
+    TestMultiply<256>(&Generator, 2000);
+    TestMultiply<512>(&Generator, 2000);
+    TestMultiply<1024>(&Generator, 1000);
+    TestMultiply<2048>(&Generator, 300);
+    TestMultiply<4096>(&Generator, 100);
+    TestComparePart();
+    TestDivisionEdgeCases();
+    TestDivisionRandom<128>(&Generator, 20000);
+    TestDivisionRandom<256>(&Generator, 20000);
+    TestDivisionRandom<512>(&Generator, 20000);
+    TestDivisionRandom<1024>(&Generator, 5000);
+    TestModularInverse<128>(&Generator, 2000);
+    TestModularInverse<256>(&Generator, 2000);
+    TestModularInverse<512>(&Generator, 500);
+    TestGCD<128>(&Generator, 2000);
+    TestGCD<512>(&Generator, 1000);
+    TestSquareRoot<128>(&Generator, 2000);
+    TestSquareRoot<256>(&Generator, 2000);
+    TestSquareRoot<1024>(&Generator, 300);
+    TestTextKnownValues();
+    TestTextConversion<64>(&Generator, 2000);
+    TestTextConversion<256>(&Generator, 2000);
+    TestTextConversion<1024>(&Generator, 500);
+    TestLiterals();
+    TestXoshiro();
+    TestChaCha();
+    TestTrialDivision();
+    TestBPSW(&Generator);
+    TestNextPrime(&Generator);
+    TestParallelSearch(&Generator);
+    TestPrimalityBatch(&Generator);
+    TestTracked<128>(&Generator, 20000);
+    TestTracked<512>(&Generator, 20000);
+    TestBatch<256>(&Generator, 3);
+    TestBatch<256>(&Generator, 301);
+    TestBatch<512>(&Generator, 64);
+    TestBatch<512>(&Generator, 203);
+    TestPollardRho();
+
+    printf("%u checks, %u failed (seed %llu)\n", TestCheckCount, TestFailureCount, (unsigned long long)Seed);
+    return TestFailureCount ? 1 : 0;
+}